@@ -27,6 +27,7 @@
 
 #include "DetectorConstruction.hh"
 #include "ActionInitialization.hh"
+#include "Benchmarks.hh"
 
 #ifdef G4MULTITHREADED
 #include "G4MTRunManager.hh"
@@ -40,6 +41,7 @@
 #include "QGSP_BERT.hh"
 #include "QGSP_BIC.hh"
 #include "NuBeam.hh"
+#include "G4FastSimulationPhysics.hh"
 
 #include "Randomize.hh"
 
@@ -120,6 +122,12 @@ int main(int argc,char** argv)
   //auto physicsList = new QGSP_BERT;
   //auto physicsList = new QGSP_BIC;
   //auto physicsList = new NuBeam;
+
+  // muon fast simulation in the rock (/FASERnu/rock/mode fast)
+  auto fastSimulationPhysics = new G4FastSimulationPhysics();
+  fastSimulationPhysics->ActivateFastSimulation("mu-");
+  fastSimulationPhysics->ActivateFastSimulation("mu+");
+  physicsList->RegisterPhysics(fastSimulationPhysics);
   runManager->SetUserInitialization(physicsList);
 
   auto actionInitialization = new ActionInitialization();
@@ -134,6 +142,9 @@ int main(int argc,char** argv)
   // Get the pointer to the User Interface manager
   auto UImanager = G4UImanager::GetUIpointer();
 
+  // Micro benchmark commands (/FASERnu/bench/)
+  auto benchmarks = new Benchmarks();
+
   // Process macro or start UI session
   //
   if ( macro.size() ) {
@@ -156,6 +167,7 @@ int main(int argc,char** argv)
   // owned and deleted by the run manager, so they should not be deleted 
   // in the main() program !
 
+  delete benchmarks;
   delete visManager;
   delete runManager;
 }
@@ -32,8 +32,15 @@
 
 #include "G4VUserActionInitialization.hh"
 
+class SourceManager;
+class EventSeeder;
+class ScoringPlanes;
+
 /// Action initialization class.
 ///
+/// It owns the objects shared read-only by the user actions of all threads,
+/// like the SourceManager, EventSeeder and ScoringPlanes configured from the macro on the
+/// master.
 
 class ActionInitialization : public G4VUserActionInitialization
 {
@@ -43,6 +50,11 @@ class ActionInitialization : public G4VUserActionInitialization
 
     virtual void BuildForMaster() const;
     virtual void Build() const;
+
+  private:
+    SourceManager* fSourceManager;
+    EventSeeder*   fEventSeeder;
+    ScoringPlanes* fScoringPlanes;
 };
 
 #endif
@@ -0,0 +1,78 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file BeamProfile.hh
+/// \brief Definition of the BeamProfile class
+
+#ifndef BeamProfile_h
+#define BeamProfile_h 1
+
+#include "globals.hh"
+
+class HistogramSampler;
+
+/// Binned transverse beam profile, optionally correlated with the energy.
+///
+/// The map is read from a text file: axis lines "x nbins min max" and
+/// "y nbins min max" (cm), an optional "e nbins min max" (GeV), then the
+/// cell weights with x running fastest, then y, then e. '#' starts a
+/// comment.
+///
+/// A single alias table over all cells picks a cell in constant time and
+/// the point is drawn uniformly inside it, so a draw costs one flat number
+/// per dimension plus one. The map is built once on the master and shared
+/// read-only by the worker threads.
+
+class BeamProfile
+{
+  public:
+    BeamProfile();
+    ~BeamProfile();
+
+    G4bool Read(const G4String& fileName);
+
+    // x, y in cm and, with an energy axis, the energy in GeV
+    void Shoot(G4double& x, G4double& y, G4double& energy) const;
+
+    // get methods
+    const G4String& GetFileName() const { return fFileName; }
+    G4bool HasEnergy() const { return fE.nofBins > 0; }
+    G4int  GetNofCells() const;
+
+  private:
+    struct Axis {
+      G4int    nofBins;
+      G4double min, width;
+    };
+
+    G4String          fFileName;
+    Axis              fX, fY, fE;
+    HistogramSampler* fCells;  // alias table over the flat cell index
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,63 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Benchmarks.hh
+/// \brief Definition of the Benchmarks class
+
+#ifndef Benchmarks_h
+#define Benchmarks_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// In-process micro benchmarks of performance critical code.
+///
+/// Each benchmark is a UI command under /FASERnu/bench/ executed on the
+/// master thread. It times the current implementation against the legacy
+/// one it replaced and prints the cost per call, so the numbers come from
+/// the same build, compiler flags and Geant4 setup as production runs.
+
+class Benchmarks
+{
+  public:
+    Benchmarks();
+    ~Benchmarks();
+
+    // benchmarks
+    void EnergySampler(G4int nofDraws);
+    void BeamProfileSampler(G4String fileName, G4int nofDraws);
+    void FieldMapEvaluation(G4String fileName, G4int nofEvaluations);
+    void StepFiltering(G4int nofSteps);
+    void HitRecording(G4int nofSteps);
+
+  private:
+    G4GenericMessenger* fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -32,27 +32,35 @@
 
 #include "G4VSensitiveDetector.hh"
 
-#include "CalorHit.hh"
-
-#include <vector>
+#include "DetectorConstruction.hh"
+#include "TrackFilmIndex.hh"
+#include "globals.hh"
 
 class G4Step;
+class G4StepPoint;
 class G4HCofThisEvent;
 
 /// Calorimeter sensitive detector class
 ///
-/// In Initialize(), it creates one hit for each calorimeter layer and one more
-/// hit for accounting the total quantities in all layers.
+/// ProcessHits(), called by Geant4 kernel at each step in the emulsion films,
+/// appends the recorded steps to the emulsion hits of the thread (see
+/// EmulsionHits), with no hit object per step. It works in stages: the steps
+/// are first rejected on what the step already holds (energy deposit, step
+/// status), the film is then read from the touchable, and the quantities of
+/// the hit are only extracted for the steps which are recorded.
 ///
-/// The values are accounted in hits in ProcessHits() function which is called
-/// by Geant4 kernel at each step.
+/// The recording policy is read from the detector at the start of each
+/// event: the film entries, every step, or one hit per track and film, made
+/// at its first step and summing the energy deposits and lengths of the
+/// following ones, found in a TrackFilmIndex reset per event.
 
 class CalorimeterSD : public G4VSensitiveDetector
 {
   public:
-    CalorimeterSD(const G4String& name, 
-		  const G4String& hitsCollectionName, 
-		  G4int nofCells);
+    using HitPolicy = DetectorConstruction::HitPolicy;
+
+    CalorimeterSD(const G4String& name, G4int nofLayers,
+                  const DetectorConstruction* detector = nullptr);
     virtual ~CalorimeterSD();
   
     // methods from base class
@@ -60,9 +68,20 @@ class CalorimeterSD : public G4VSensitiveDetector
     virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
     virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
 
+    // set methods
+    void SetNofLayers(G4int nofLayers) { fNofLayers = nofLayers; }
+    // without detector, kept from event to event
+    void SetHitPolicy(HitPolicy policy) { fPolicy = policy; }
+
   private:
-    CalorHitsCollection* fHitsCollection;
-    G4int  fNofLayers;
+    void Record(const G4Step* step, const G4StepPoint* preStepPoint,
+                G4int layer, G4int film);
+
+    const DetectorConstruction* fDetector;
+    G4int     fNofLayers;
+    HitPolicy fPolicy;
+    // hit of each (track, layer, film) of the event, for the track policy
+    TrackFilmIndex fTrackHits;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
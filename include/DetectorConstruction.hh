@@ -35,6 +35,11 @@
 
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
+class DetectorMessenger;
+class FieldMap;
+class OverlapChecker;
+class RockTables;
+class RockTransportModel;
 
 /// Detector construction class to define materials and geometry.
 /// The calorimeter is a box made of a given number of layers. A layer consists
@@ -51,6 +56,46 @@ class G4GlobalMagFieldMessenger;
 /// are created and associated with the Absorber and Gap volumes.
 /// In addition a transverse uniform magnetic field is defined 
 /// via G4GlobalMagFieldMessenger class.
+///
+/// The number of layers and the absorber, emulsion and base thicknesses
+/// are set with the /FASERnu/det/ commands of DetectorMessenger. A change
+/// rebuilds the geometry before the next run; the materials, the sensitive
+/// detector and the field messenger are created once and reused.
+///
+/// With a GDML cache directory set (and Geant4 built with GDML), the
+/// constructed geometry is written once to a snapshot named after a hash
+/// of these parameters; later jobs with the same parameters read it back
+/// instead of building the materials and volumes, and skip the overlap
+/// checks and the material dump. Bump kGeometryVersion in
+/// DetectorConstruction.cc whenever DefineVolumes() changes.
+///
+/// Volumes are placed without overlap checks. The check is a separate
+/// validation step (/FASERnu/det/checkOverlaps) run in parallel by
+/// OverlapChecker, whose pass/fail results are cached per geometry hash;
+/// every construction reports whether its geometry was validated.
+///
+/// The Rock, Gap and Calorimeter volumes are the roots of regions of the
+/// same names, so that their production cuts can be set independently
+/// with /run/setCutForRegion after /run/initialize.
+///
+/// The muon transport through the rock is selected with /FASERnu/rock/mode:
+/// full simulation, calibration (full simulation filling the RockTables,
+/// written at the end of run) or fast simulation with RockTransportModel,
+/// attached to the Rock region, using the tables read from the same file.
+/// With /FASERnu/rock/validate the flux spectra of a fast run are compared
+/// with those of the last full run.
+///
+/// Secondaries which cannot leave the rock are killed by StackingAction
+/// when the range rejection is on (/FASERnu/rock/rangeKill, default off).
+///
+/// A field map read with /FASERnu/det/fieldMap replaces the uniform field:
+/// the map is loaded once on the master and each thread installs its own
+/// FieldMap copy, sharing the grid, in the global field manager. A map
+/// which cannot be read is rejected with a warning and the field is kept.
+///
+/// The steps recorded in the emulsion films by CalorimeterSD are selected
+/// with /FASERnu/det/hitPolicy: the film entries (default), every step, or
+/// one hit per track and film summing its steps.
 
 class DetectorConstruction : public G4VUserDetectorConstruction
 {
@@ -58,22 +103,84 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     DetectorConstruction();
     virtual ~DetectorConstruction();
 
+    enum RockMode { kRockFull, kRockCalibrate, kRockFast };
+    enum HitPolicy { kHitEntry, kHitStep, kHitTrack };
+
   public:
     virtual G4VPhysicalVolume* Construct();
     virtual void ConstructSDandField();
+
+    // set methods
+    void SetNofLayers(G4int nofLayers);
+    void SetAbsorberThickness(G4double thickness);
+    void SetEmulsionThickness(G4double thickness);
+    void SetBaseThickness(G4double thickness);
+    void SetGdmlCache(const G4String& directory);
+    void SetPrintMaterials(G4bool print) { fPrintMaterials = print; }
+    void SetOverlapCache(const G4String& fileName);
+    void SetRockMode(RockMode mode);
+    void SetRockTablesFile(const G4String& fileName) { fRockTablesFile = fileName; }
+    void SetValidateRock(G4bool validate) { fValidateRock = validate; }
+    void SetRangeKill(G4bool rangeKill) { fRangeKill = rangeKill; }
+    void SetRangeMargin(G4double margin) { fRangeMargin = margin; }
+    void SetFieldMap(const G4String& fileName);
+    void SetHitPolicy(HitPolicy policy) { fHitPolicy = policy; }
+
+    // validate the constructed geometry
+    G4bool CheckOverlaps(G4int resolution, G4double tolerance, G4int nofThreads);
+
+    // get methods
+    G4int GetNofLayers() const { return fNofLayers; }
+    // hex digest of the geometry version and parameters
+    G4String GetGeometryHash() const;
+    RockMode GetRockMode() const { return fRockMode; }
+    const G4String& GetRockTablesFile() const { return fRockTablesFile; }
+    const RockTables* GetRockTables() const { return fRockTables; }
+    G4bool GetValidateRock() const { return fValidateRock; }
+    G4bool GetRangeKill() const { return fRangeKill; }
+    G4double GetRangeMargin() const { return fRangeMargin; }
+    const FieldMap* GetFieldMap() const { return fFieldMap; }
+    HitPolicy GetHitPolicy() const { return fHitPolicy; }
      
   private:
     // methods
     //
     void DefineMaterials();
     G4VPhysicalVolume* DefineVolumes();
+    void DefineVisAttributes();
+    void DefineRegions();
+    void RebuildGeometry();
+    G4VPhysicalVolume* ReadGdmlCache(const G4String& fileName);
+    void WriteGdmlCache(const G4String& fileName, const G4VPhysicalVolume* worldPV) const;
   
     // data members
     //
     static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger; // magnetic field messenger
+    static G4ThreadLocal RockTransportModel*         fRockModel;         // fast rock transport
+    static G4ThreadLocal FieldMap*                   fThreadFieldMap;    // installed field map
+
+    DetectorMessenger* fMessenger;
+    OverlapChecker*    fOverlapChecker;
+    G4String           fBuiltHash;   // of the constructed geometry
+
+    G4bool   fCheckOverlaps; // option to activate checking of volumes overlaps
+    G4int    fNofLayers;     // number of layers
+    G4double fAbsoThickness; // lead plate
+    G4double fEmulThickness; // each of the two emulsion films
+    G4double fBaseThickness; // plastic base between the films
+    G4String fGdmlCacheDir;  // geometry snapshots, none if empty
+    G4bool   fPrintMaterials;
+
+    RockMode    fRockMode;
+    G4String    fRockTablesFile;
+    RockTables* fRockTables;     // read for the fast mode, shared by the threads
+    G4bool      fValidateRock;
+    G4bool      fRangeKill;      // of the secondaries which cannot leave the rock
+    G4double    fRangeMargin;
+
+    FieldMap*   fFieldMap;       // read on the master, none if null
 
-    G4bool  fCheckOverlaps; // option to activate checking of volumes overlaps
-    G4int   fNofLayers;     // number of layers
+    HitPolicy   fHitPolicy;      // steps recorded by the emulsion SD
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DetectorMessenger.hh
+/// \brief Definition of the DetectorMessenger class
+
+#ifndef DetectorMessenger_h
+#define DetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+class G4UIcommand;
+
+/// Messenger of the DetectorConstruction, commands in /FASERnu/det/ and
+/// /FASERnu/rock/.
+///
+/// The commands are executed on the master thread only; each of the
+/// geometry parameters triggers a rebuild of the geometry, which is
+/// propagated to the workers at the next run.
+
+class DetectorMessenger : public G4UImessenger
+{
+  public:
+    DetectorMessenger(DetectorConstruction* detector);
+    virtual ~DetectorMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    DetectorConstruction*      fDetector;
+
+    G4UIdirectory*             fDetDir;
+    G4UIcmdWithAnInteger*      fNofLayersCmd;
+    G4UIcmdWithADoubleAndUnit* fAbsoThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fEmulThicknessCmd;
+    G4UIcmdWithADoubleAndUnit* fBaseThicknessCmd;
+    G4UIcmdWithAString*        fGdmlCacheCmd;
+    G4UIcmdWithABool*          fPrintMaterialsCmd;
+    G4UIcommand*               fCheckOverlapsCmd;
+    G4UIcmdWithAString*        fOverlapCacheCmd;
+    G4UIcmdWithAString*        fFieldMapCmd;
+    G4UIcmdWithAString*        fHitPolicyCmd;
+
+    G4UIdirectory*             fRockDir;
+    G4UIcmdWithAString*        fRockModeCmd;
+    G4UIcmdWithAString*        fRockTablesCmd;
+    G4UIcmdWithABool*          fValidateRockCmd;
+    G4UIcmdWithABool*          fRangeKillCmd;
+    G4UIcmdWithADoubleAndUnit* fRangeMarginCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,140 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EmulsionHits.hh
+/// \brief Definition of the EmulsionHits class
+
+#ifndef EmulsionHits_h
+#define EmulsionHits_h 1
+
+#include "G4ThreeVector.hh"
+#include "G4SystemOfUnits.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Per-thread hits of the emulsion films in one event, one array per
+/// quantity.
+///
+/// CalorimeterSD appends the boundary steps with Add() and the arrays are
+/// the ones bound to the ntuple columns, so nothing is copied at the end of
+/// event. Clear() keeps the capacity: after Reserve() and the first large
+/// events the store no longer allocates. Positions are in mm, momenta and
+/// energies in MeV, the process which limited the step is an identifier of
+/// the ProcessRegistry.
+
+class EmulsionHits
+{
+  public:
+    EmulsionHits();
+    ~EmulsionHits();
+
+    void Clear();
+    void Reserve(std::size_t nofHits);
+    void Print(std::size_t maxHits) const;
+
+    void Add(G4int layer, G4int film, G4int particleID, G4int trackID,
+             G4int parentID, G4double particleCharge, const G4ThreeVector& position,
+             const G4ThreeVector& momentum, G4double kE1, G4double kE2,
+             G4double energyDeposit, G4double length, G4int processID);
+
+    // a further step of the track in the film of the hit
+    void Accumulate(std::size_t hit, G4double kE2, G4double energyDeposit,
+                    G4double length);
+
+    std::size_t GetSize() const { return pdgid.size(); }
+    // steps recorded, more than the hits when they are aggregated
+    std::size_t GetNofSteps() const { return fNofSteps; }
+
+    // the ntuple columns
+    std::vector<int>    cham;
+    std::vector<int>    idz;
+    std::vector<int>    idzsub;
+    std::vector<int>    pdgid;
+    std::vector<int>    id;
+    std::vector<int>    idParent;
+    std::vector<double> charge;
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+    std::vector<double> px;
+    std::vector<double> py;
+    std::vector<double> pz;
+    std::vector<double> e1;
+    std::vector<double> e2;
+    std::vector<double> len;
+    std::vector<double> edep;
+    std::vector<int>    proc;   // see ProcessRegistry
+
+  private:
+    std::size_t fNofSteps;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EmulsionHits::Add(G4int layer, G4int film, G4int particleID,
+                              G4int trackID, G4int parentID, G4double particleCharge,
+                              const G4ThreeVector& position,
+                              const G4ThreeVector& momentum,
+                              G4double kE1, G4double kE2,
+                              G4double energyDeposit, G4double length,
+                              G4int processID)
+{
+  ++fNofSteps;
+  cham.push_back(0);
+  idz.push_back(layer);
+  idzsub.push_back(film);
+  pdgid.push_back(particleID);
+  id.push_back(trackID);
+  idParent.push_back(parentID);
+  charge.push_back(particleCharge);
+  x.push_back(position.x()/mm);
+  y.push_back(position.y()/mm);
+  z.push_back(position.z()/mm);
+  px.push_back(momentum.x()/MeV);
+  py.push_back(momentum.y()/MeV);
+  pz.push_back(momentum.z()/MeV);
+  e1.push_back(kE1/MeV);
+  e2.push_back(kE2/MeV);
+  len.push_back(length/mm);
+  edep.push_back(energyDeposit/MeV);
+  proc.push_back(processID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EmulsionHits::Accumulate(std::size_t hit, G4double kE2,
+                                     G4double energyDeposit, G4double length)
+{
+  ++fNofSteps;
+  e2[hit] = kE2/MeV;
+  edep[hit] += energyDeposit/MeV;
+  len[hit] += length/mm;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
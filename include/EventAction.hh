@@ -32,32 +32,49 @@
 
 #include "G4UserEventAction.hh"
 
-#include "CalorHit.hh"
+#include "PhaseSpaceFile.hh"
 
 #include "globals.hh"
 
+#include <vector>
+
+class RunAction;
+class SourceManager;
+
 /// Event action class
 ///
-/// In EndOfEventAction(), it prints the accumulated quantities of the energy 
-/// deposit and track lengths of charged particles in Absober and Gap layers 
-/// stored in the hits collections.
+/// In BeginOfEventAction(), it clears the emulsion hits of the thread,
+/// which CalorimeterSD then fills and the ntuple columns read directly.
+/// EndOfEventAction() counts them, and the steps recorded, in RunAction.
+///
+/// When a phase space is recorded, it collects the absorber entries found
+/// by SteppingAction and writes them in one block at the end of event.
 
 class EventAction : public G4UserEventAction
 {
 public:
-  EventAction();
+  EventAction(RunAction* runAction, const SourceManager* sourceManager = nullptr);
   virtual ~EventAction();
 
   virtual void  BeginOfEventAction(const G4Event* event);
   virtual void    EndOfEventAction(const G4Event* event);
+
+  // stage-1 recording of this event, null if none
+  PhaseSpaceWriter* GetPhaseSpaceOutput() const { return fPhaseSpaceOutput; }
+  void AddCrossing(const PhaseSpaceRecord& record) { fCrossings.push_back(record); }
     
 private:
   // methods
-  CalorHitsCollection* GetCalorHitsCollection(G4int hcID, const G4Event* event) const;
   void PrintEventStatistics(G4double Edep) const;
+
+  // hits reserved per thread, the store then grows to the largest event
+  static const std::size_t kInitialHits = 10000;
   
   // data members
-  G4int  fCalorHCID;
+  RunAction*                    fRunAction;
+  const SourceManager*          fSourceManager;    // shared, read-only
+  PhaseSpaceWriter*             fPhaseSpaceOutput; // thread safe
+  std::vector<PhaseSpaceRecord> fCrossings;
 };
                      
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSeeder.hh
+/// \brief Definition of the EventSeeder class
+
+#ifndef EventSeeder_h
+#define EventSeeder_h 1
+
+#include "globals.hh"
+
+class G4GenericMessenger;
+
+/// Optional per-event seeding from (run seed, run ID, event ID).
+///
+/// When enabled, the generator reseeds the thread-local engine at the start
+/// of each event with seeds derived by the Philox4x32 counter-based generator
+/// from the run seed and the event number. The random stream of an event
+/// then depends neither on the number of threads nor on which thread picks
+/// the event up, and any event can be rerun alone by setting the event
+/// offset to its number and shooting one event.
+///
+/// Commands in /FASERnu/random/, executed on the master only; the workers
+/// only read the values during the run.
+
+class EventSeeder
+{
+  public:
+    EventSeeder();
+    ~EventSeeder();
+
+    /// Reseed the engine of the calling thread, no-op when disabled.
+    void SeedEvent(G4int runID, G4int eventID) const;
+
+    G4bool IsEnabled() const { return fEnabled; }
+
+  private:
+    G4GenericMessenger* fMessenger;
+
+    G4bool fEnabled;
+    G4int  fRunSeed;
+    G4int  fEventOffset;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldMap.hh
+/// \brief Definition of the FieldMap class
+
+#ifndef FieldMap_h
+#define FieldMap_h 1
+
+#include "G4MagneticField.hh"
+#include "globals.hh"
+
+#include <memory>
+#include <vector>
+
+/// Magnetic field interpolated trilinearly in a 3D grid.
+///
+/// The grid is read from a binary file: an 80-byte header (magic, version,
+/// number of points along x, y and z, low and high grid corners in mm)
+/// followed by Bx, By, Bz in tesla as floats for each point, x running
+/// fastest, then y, then z. It is kept in one flat array in the same
+/// order, so the 8 corners of a cell lie in 4 pairs of adjacent points.
+/// Outside the grid the field is zero.
+///
+/// Copies share the grid and have their own cache of the last cell: the
+/// corners are only gathered again when a point falls in another cell,
+/// which is rare along a track. Each thread evaluates its own copy.
+
+class FieldMap : public G4MagneticField
+{
+  public:
+    FieldMap();
+    FieldMap(const FieldMap& other);
+    virtual ~FieldMap();
+
+    // false if missing, not a field map or if its size does not match the
+    // grid of its header, the map is then unchanged
+    G4bool Read(const G4String& fileName);
+    G4bool Write(const G4String& fileName) const;
+    // nofPoints >= 2 per axis, corners in mm, values in tesla as on file
+    G4bool SetGrid(const G4int nofPoints[3], const G4double min[3],
+                   const G4double max[3], const std::vector<float>& values);
+
+    virtual void GetFieldValue(const G4double point[4], G4double* field) const;
+    virtual G4Field* Clone() const;
+
+    // get methods
+    const G4String& GetFileName() const { return fFileName; }
+    G4int GetNofPoints() const;
+
+  private:
+    FieldMap& operator=(const FieldMap&) = delete;
+
+    struct Grid {
+      G4int    nofPoints[3];
+      G4double min[3], max[3];
+      G4double inverseStep[3];
+      std::vector<float> values;  // 3 per point
+    };
+
+    std::shared_ptr<const Grid> fGrid;
+    G4String                    fFileName;
+
+    // last cell: flat index of its low corner, -1 if none, and the field
+    // at its corners (bit 0 of the corner index for x, 1 for y, 2 for z)
+    mutable G4long   fCell;
+    mutable G4double fCorners[8][3];
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,97 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistogramBuffer.hh
+/// \brief Definition of the HistogramBuffer class
+
+#ifndef HistogramBuffer_h
+#define HistogramBuffer_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Per-thread buffer of the fixed-bin H1 histograms booked in RunAction.
+///
+/// Attach() copies the binning of the histograms of the analysis manager
+/// at the start of run. Fill() then computes the bin directly and sums the
+/// weights and moments in plain arrays, with no analysis manager lookup;
+/// Flush() adds the non-empty bins to the histograms at the end of run,
+/// before they are merged and written, with the same statistics as if
+/// each entry had been filled there.
+
+class HistogramBuffer
+{
+  public:
+    HistogramBuffer();
+    ~HistogramBuffer();
+
+    void Attach();
+    void Flush();
+
+    void Fill(G4int id, G4double x, G4double weight = 1.);
+
+  private:
+    struct Bin {
+      G4long   entries;
+      G4double sumW, sumW2, sumXW, sumX2W;
+    };
+    struct Histogram {
+      G4double         min, width;
+      G4int            nofBins;
+      G4bool           filled;
+      std::vector<Bin> bins;   // underflow, nofBins, overflow
+    };
+
+    std::vector<Histogram> fHistograms;   // by histogram id
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void HistogramBuffer::Fill(G4int id, G4double x, G4double weight)
+{
+  if ( id < 0 || id >= G4int(fHistograms.size()) ) return;
+  Histogram& histogram = fHistograms[id];
+  if ( histogram.nofBins == 0 ) return;
+
+  // the bin as found by the tools histograms
+  G4double t = (x - histogram.min)/histogram.width;
+  G4int bin = ( t < 0. ) ? 0
+            : ( t >= histogram.nofBins ) ? histogram.nofBins+1
+            : G4int(t)+1;
+
+  Bin& content = histogram.bins[bin];
+  content.entries += 1;
+  content.sumW    += weight;
+  content.sumW2   += weight*weight;
+  content.sumXW   += x*weight;
+  content.sumX2W  += x*x*weight;
+  histogram.filled = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
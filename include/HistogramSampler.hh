@@ -0,0 +1,140 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistogramSampler.hh
+/// \brief Definition of the HistogramSampler class
+
+#ifndef HistogramSampler_h
+#define HistogramSampler_h 1
+
+#include "globals.hh"
+#include "Randomize.hh"
+
+#include <vector>
+
+/// Random sampler for a binned (histogram) distribution.
+///
+/// The bin is chosen in constant time with the Walker/Vose alias method, the
+/// value inside the bin is then drawn either uniformly or from a linear
+/// density joining the neighbouring bin heights. A draw costs two flat
+/// random numbers whatever the number of bins.
+///
+/// The tables are built once in the constructor and never modified, so a
+/// single instance can be shared read-only by all worker threads; each
+/// thread passes its own random engine (or uses its thread-local default).
+
+class HistogramSampler
+{
+  public:
+    enum Interpolation { kUniform, kLinear };
+
+    HistogramSampler(const std::vector<G4double>& binEdges,
+                     const std::vector<G4double>& binWeights,
+                     Interpolation interpolation = kUniform);
+    ~HistogramSampler();
+
+    // sampling methods
+    G4int    ShootBin(CLHEP::HepRandomEngine* engine) const;
+    G4double Shoot(CLHEP::HepRandomEngine* engine) const;
+    G4int    ShootBin() const;
+    G4double Shoot() const;
+
+    // deterministic versions, u1 and u2 uniform in [0,1)
+    G4int    SampleBin(G4double u1) const;
+    G4double Sample(G4double u1, G4double u2) const;
+    G4double SampleInBin(G4int bin, G4double u2) const;
+
+    // get methods
+    G4int    GetNofBins() const;
+    G4double GetLowEdge(G4int bin) const;
+    G4double GetHighEdge(G4int bin) const;
+    G4double GetBinProbability(G4int bin) const;
+    G4double GetIntegral() const;
+    Interpolation GetInterpolation() const;
+
+  private:
+    void BuildAliasTable();
+    void BuildEdgeDensities();
+
+    Interpolation          fInterpolation;
+    std::vector<G4double>  fEdges;       // nbins+1 bin edges
+    std::vector<G4double>  fProb;        // normalised bin probabilities
+    std::vector<G4double>  fAliasCut;    // Vose acceptance threshold per bin
+    std::vector<G4int>     fAlias;       // Vose alias bin
+    std::vector<G4double>  fEdgeDensity; // density at edges (kLinear only)
+    G4double               fIntegral;    // sum of the input weights
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int HistogramSampler::ShootBin(CLHEP::HepRandomEngine* engine) const
+{
+  return SampleBin(engine->flat());
+}
+
+inline G4double HistogramSampler::Shoot(CLHEP::HepRandomEngine* engine) const
+{
+  G4double u1 = engine->flat();
+  return Sample(u1, engine->flat());
+}
+
+inline G4int HistogramSampler::ShootBin() const
+{
+  return SampleBin(G4UniformRand());
+}
+
+inline G4double HistogramSampler::Shoot() const
+{
+  G4double u1 = G4UniformRand();
+  return Sample(u1, G4UniformRand());
+}
+
+inline G4int HistogramSampler::SampleBin(G4double u1) const
+{
+  // one flat number gives both the column and the acceptance test
+  G4int nofBins = fProb.size();
+  G4double scaled = u1*nofBins;
+  G4int bin = static_cast<G4int>(scaled);
+  if ( bin >= nofBins ) bin = nofBins-1;
+  return ( scaled-bin < fAliasCut[bin] ) ? bin : fAlias[bin];
+}
+
+inline G4double HistogramSampler::Sample(G4double u1, G4double u2) const
+{
+  return SampleInBin(SampleBin(u1), u2);
+}
+
+inline G4int HistogramSampler::GetNofBins() const { return fProb.size(); }
+inline G4double HistogramSampler::GetLowEdge(G4int bin) const { return fEdges[bin]; }
+inline G4double HistogramSampler::GetHighEdge(G4int bin) const { return fEdges[bin+1]; }
+inline G4double HistogramSampler::GetBinProbability(G4int bin) const { return fProb[bin]; }
+inline G4double HistogramSampler::GetIntegral() const { return fIntegral; }
+inline HistogramSampler::Interpolation HistogramSampler::GetInterpolation() const
+{ return fInterpolation; }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
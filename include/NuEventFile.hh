@@ -0,0 +1,143 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file NuEventFile.hh
+/// \brief Definition of the neutrino event file classes
+
+#ifndef NuEventFile_h
+#define NuEventFile_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// One final state particle of a neutrino interaction.
+
+struct NuParticle
+{
+  G4int    pdg;
+  G4double px, py, pz; // momentum in GeV
+};
+
+/// One externally generated neutrino interaction: the summary filled in
+/// the *_nuEvt variables of Analysis.hh and the final state particles,
+/// all produced at the interaction vertex.
+
+struct NuEvent
+{
+  G4int    number;    // in the input file
+  G4int    pdgNu;     // incoming neutrino
+  G4int    pdgLep;    // outgoing lepton, 0 if none
+  G4double eNu;       // neutrino energy in GeV
+  G4double pLep;      // lepton momentum in GeV
+  G4int    cc;        // 1 for charged current, 0 for neutral current
+  G4double x, y, z;   // vertex in cm
+  G4double weight;    // event weight
+  std::vector<NuParticle> particles;
+};
+
+/// Writer of the binary neutrino event format: a 16-byte header (magic,
+/// version) followed, for each event, by a fixed size summary and its
+/// final state particles.
+
+class NuEventWriter
+{
+  public:
+    NuEventWriter();
+    ~NuEventWriter();
+
+    G4bool Open(const G4String& fileName);
+    void   Write(const NuEvent& event);
+    void   Close();
+
+    std::uint64_t GetNofEvents() const { return fNofEvents; }
+
+  private:
+    std::ofstream fOutput;
+    std::uint64_t fNofEvents;
+};
+
+/// Reader of neutrino interactions from a HepMC2 ASCII (IO_GenEvent) file
+/// or from the binary format of NuEventWriter, recognised by its magic.
+/// HepMC3 ASCII files are recognised by their header and not opened.
+///
+/// A background thread parses ahead into a bounded queue, so the workers
+/// only take the next ready event under a short lock and never wait on the
+/// file unless the reader falls behind. Events are served in file order
+/// to whichever worker asks first, the event ID mapping therefore depends
+/// on the scheduling but each event keeps its file number.
+///
+/// From HepMC the first vertex gives the position, the first neutrino that
+/// is not final state (status != 1) the incoming neutrino and the status 1
+/// particles the final state; the lepton of the same flavour decides
+/// between charged and neutral current.
+
+class NuEventReader
+{
+  public:
+    NuEventReader(std::size_t capacity = 1024);
+    ~NuEventReader();
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    // next event in file order, false when the file is exhausted
+    G4bool Next(NuEvent& event);
+
+    const G4String& GetFileName() const { return fFileName; }
+    G4bool IsBinary() const { return fBinary; }
+
+  private:
+    void   ReadAhead();
+    G4bool ReadHepMC(NuEvent& event);
+    G4bool ReadBinary(NuEvent& event);
+
+    G4String      fFileName;
+    std::ifstream fInput;
+    G4bool        fBinary;
+    std::string   fPendingLine;  // E line of the next HepMC event
+    G4double      fEnergyUnit;   // to GeV, from the HepMC U line
+    G4double      fLengthUnit;   // to cm
+
+    std::size_t             fCapacity;
+    std::deque<NuEvent>     fQueue;
+    std::mutex              fMutex;
+    std::condition_variable fNotEmpty;
+    std::condition_variable fNotFull;
+    G4bool                  fEndOfFile;
+    G4bool                  fStop;
+    std::thread             fThread;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OverlapChecker.hh
+/// \brief Definition of the OverlapChecker class
+
+#ifndef OverlapChecker_h
+#define OverlapChecker_h 1
+
+#include "globals.hh"
+
+/// Overlap validation of the constructed geometry, on demand.
+///
+/// All placed (non replicated) daughter volumes of the physical volume
+/// store are checked with G4VPhysicalVolume::CheckOverlaps() by a pool of
+/// threads that take volumes one at a time, so the large and the small
+/// volumes balance over the threads.
+///
+/// The outcome is appended to a cache file as a line
+/// "<geometry hash> <resolution> <tolerance in mm> pass|fail", which lets
+/// production jobs report whether their geometry was validated without
+/// running the check themselves.
+
+class OverlapChecker
+{
+  public:
+    OverlapChecker();
+    ~OverlapChecker();
+
+    // check the current geometry, true when no overlap is found
+    G4bool Check(const G4String& geometryHash, G4int resolution,
+                 G4double tolerance, G4int nofThreads);
+
+    // last cached result for the hash: 1 pass, 0 fail, -1 none
+    G4int GetCachedResult(const G4String& geometryHash) const;
+
+    void SetCacheFile(const G4String& fileName) { fCacheFile = fileName; }
+    const G4String& GetCacheFile() const { return fCacheFile; }
+
+  private:
+    G4String fCacheFile;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
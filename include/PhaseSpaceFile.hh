@@ -0,0 +1,147 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceFile.hh
+/// \brief Definition of the phase space file classes
+
+#ifndef PhaseSpaceFile_h
+#define PhaseSpaceFile_h 1
+
+#include "G4VUserPrimaryParticleInformation.hh"
+#include "globals.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+/// One particle crossing from the Gap into the first absorber, 52 bytes on
+/// file: the stage-1 event it belongs to and its full phase space.
+
+struct PhaseSpaceRecord
+{
+  std::int32_t run;        // stage-1 run and event IDs
+  std::int32_t event;
+  std::int32_t pdg;
+  std::int32_t parent;     // stage-1 parent track ID, 0 for the primary
+  float        energy;     // kinetic energy in GeV
+  float        x, y, z;    // crossing point in cm
+  float        dx, dy, dz; // unit momentum direction
+  float        time;       // global time in ns
+  float        weight;     // event weight
+};
+
+/// Writer of a phase space file: a 32-byte header (magic, version, record
+/// size, number of records, number of stage-1 events) followed by the raw
+/// records.
+///
+/// It is shared by the worker threads: each one collects the crossings of
+/// an event and writes them in one call, so that the records of an event
+/// are contiguous on file. Every event is counted, with or without
+/// crossings, to normalise the replayed flux.
+
+class PhaseSpaceWriter
+{
+  public:
+    PhaseSpaceWriter();
+    ~PhaseSpaceWriter();
+
+    G4bool Open(const G4String& fileName, G4bool killAtBoundary);
+    void   Write(const std::vector<PhaseSpaceRecord>& records);
+    void   Close();
+
+    const G4String& GetFileName() const { return fFileName; }
+    std::uint64_t GetNofRecords() const { return fNofRecords; }
+    std::uint64_t GetNofEvents() const { return fNofEvents; }
+    // the recorded particles are not tracked any further
+    G4bool GetKillAtBoundary() const { return fKillAtBoundary; }
+
+  private:
+    G4String                   fFileName;
+    std::ofstream              fOutput;
+    std::mutex                 fMutex;
+    std::uint64_t              fNofRecords;
+    std::atomic<std::uint64_t> fNofEvents;
+    G4bool                     fKillAtBoundary;
+};
+
+/// Read-only memory map of a phase space file.
+///
+/// Open() indexes the stage-1 events that have crossings, the records of
+/// event i are then accessed in place; the map is shared by all threads
+/// without locking.
+
+class PhaseSpaceReader
+{
+  public:
+    PhaseSpaceReader();
+    ~PhaseSpaceReader();
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    // stage-1 events with crossings, and all stage-1 events
+    std::uint64_t GetNofEvents() const { return fEventStart.size()-1; }
+    std::uint64_t GetNofGeneratedEvents() const { return fNofGeneratedEvents; }
+    std::uint64_t GetNofRecords() const { return fNofRecords; }
+    const PhaseSpaceRecord* GetEventBegin(std::uint64_t i) const
+    { return fRecords + fEventStart[i]; }
+    const PhaseSpaceRecord* GetEventEnd(std::uint64_t i) const
+    { return fRecords + fEventStart[i+1]; }
+    const G4String& GetFileName() const { return fFileName; }
+
+  private:
+    G4String                   fFileName;
+    void*                      fMap;
+    std::size_t                fMapSize;
+    const PhaseSpaceRecord*    fRecords;
+    std::uint64_t              fNofRecords;
+    std::uint64_t              fNofGeneratedEvents;
+    std::vector<std::uint64_t> fEventStart;  // first record of each event, then the end
+};
+
+/// Stage-1 origin of a replayed particle, attached to its primary so that
+/// the stage-1 primary keeps its own flux histogram.
+
+class PhaseSpaceInfo : public G4VUserPrimaryParticleInformation
+{
+  public:
+    PhaseSpaceInfo(G4int parent) : fParent(parent) {}
+    virtual ~PhaseSpaceInfo() {}
+
+    virtual void Print() const;
+
+    G4int GetParent() const { return fParent; }
+
+  private:
+    G4int fParent;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
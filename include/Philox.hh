@@ -0,0 +1,77 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Philox.hh
+/// \brief Definition of the Philox4x32 counter-based generator
+
+#ifndef Philox_h
+#define Philox_h 1
+
+#include <cstdint>
+
+/// Philox4x32-10 counter-based random number generator
+/// (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11).
+///
+/// It is a keyed bijection of a 128-bit counter: the same (key, counter)
+/// always gives the same four 32-bit words, whatever was drawn before and
+/// on whichever thread, so it has no state to share or to seed.
+
+namespace Philox4x32
+{
+  inline void MulHiLo(std::uint32_t a, std::uint32_t b,
+                      std::uint32_t& hi, std::uint32_t& lo)
+  {
+    std::uint64_t product = static_cast<std::uint64_t>(a)*b;
+    hi = static_cast<std::uint32_t>(product >> 32);
+    lo = static_cast<std::uint32_t>(product);
+  }
+
+  /// Fill out[4] with the words for counter[4] and key[2].
+  inline void Generate(const std::uint32_t counter[4],
+                       const std::uint32_t key[2],
+                       std::uint32_t out[4])
+  {
+    const std::uint32_t kM0 = 0xD2511F53, kM1 = 0xCD9E8D57;
+    const std::uint32_t kW0 = 0x9E3779B9, kW1 = 0xBB67AE85;
+
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+      std::uint32_t hi0, lo0, hi1, lo1;
+      MulHiLo(kM0, c0, hi0, lo0);
+      MulHiLo(kM1, c2, hi1, lo1);
+      c0 = hi1^c1^k0;
+      c1 = lo1;
+      c2 = hi0^c3^k1;
+      c3 = lo0;
+      k0 += kW0;
+      k1 += kW1;
+    }
+    out[0] = c0; out[1] = c1; out[2] = c2; out[3] = c3;
+  }
+}
+
+#endif
@@ -39,6 +39,11 @@
 using namespace std;
 
 class G4ParticleGun;
+class SourceManager;
+class EventSeeder;
+class NuEventReader;
+struct NuEvent;
+class PhaseSpaceReader;
 class G4ParticleDefinition;
 class G4Event;
 
@@ -48,11 +53,29 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class 
 /// (see the macros provided with this example).
+///
+/// One instance lives on each worker thread and owns all of its mutable state
+/// (particle gun, cached world size); the SourceManager is shared read-only
+/// between threads, so GeneratePrimaries() runs without any lock.
+///
+/// The kinematics are either sampled from the sources of the SourceManager
+/// or, when a primary stream is replayed, read from the record indexed by
+/// the event ID. The EventSeeder optionally reseeds the random engine from
+/// the event number first.
+///
+/// When a neutrino event file is open, each event instead takes the next
+/// interaction from the shared prefetching reader and shoots all its final
+/// state particles from the interaction vertex.
+///
+/// In stage 2 of a two-stage simulation, each event replays the particles
+/// of one recorded event of a phase space file at the calorimeter face of
+/// the current geometry, with their recorded weight.
 
 class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
 public:
-  PrimaryGeneratorAction();    
+  PrimaryGeneratorAction(const SourceManager* sourceManager,
+                         const EventSeeder* eventSeeder = nullptr);
   virtual ~PrimaryGeneratorAction();
 
   virtual void GeneratePrimaries(G4Event* event);
@@ -61,43 +84,23 @@ public:
   void SetRandomFlag(G4bool value);
 
 private:
+  void CacheGeometry();
+  void GenerateNuEvent(G4Event* event, NuEventReader* nuEvents);
+  void GeneratePhaseSpace(G4Event* event, const PhaseSpaceReader* phaseSpace);
+
+  const SourceManager* fSourceManager; // shared, read-only
+  const EventSeeder*   fEventSeeder;   // shared, read-only
   G4ParticleGun*  fParticleGun; // G4 particle gun
-  G4ParticleDefinition* fElectron;
-  G4ParticleDefinition* fPositron;
-  G4ParticleDefinition* fMuonM;
-  G4ParticleDefinition* fMuonP;
-  G4ParticleDefinition* fPionM;
-  G4ParticleDefinition* fPionP;
-  G4ParticleDefinition* fPi0;
-  G4ParticleDefinition* fProton;
-  G4ParticleDefinition* fProtonB;
-  G4ParticleDefinition* fNeutron;
-  G4ParticleDefinition* fNeutronB;
-  G4ParticleDefinition* fPhoton;
-  G4ParticleDefinition* fK0;
-  G4ParticleDefinition* fK0B;
-  G4ParticleDefinition* fKL0;
-  G4ParticleDefinition* fKS0;
-  G4ParticleDefinition* fKaonM;
-  G4ParticleDefinition* fKaonP;
-  G4ParticleDefinition* fSigmaM;
-  G4ParticleDefinition* fSigmaMB;
-  G4ParticleDefinition* fSigmaP;
-  G4ParticleDefinition* fSigmaPB;
-  G4ParticleDefinition* fSigma0;
-  G4ParticleDefinition* fSigma0B;
-  G4ParticleDefinition* fLambda0;
-  G4ParticleDefinition* fLambda0B;
-  G4ParticleDefinition* fDP;
-  G4ParticleDefinition* fDM;
-  G4ParticleDefinition* fD0;
-  G4ParticleDefinition* fD0B;
-  G4ParticleDefinition* fDsP;
-  G4ParticleDefinition* fDsM;
-  G4ParticleDefinition* fAlpha;
-  G4ParticleDefinition* fAlphaB;
 
-  G4RandGeneral* rand_general;
+  G4int    fGeometryRunID;    // run of the cached volume dimensions
+  G4double fWorldZHalfLength; // cached on the first event of a run
+  G4double fCalorimeterFaceZ; // likewise
+  G4int    fReplayPdg;        // last replayed PDG code
+  G4ParticleDefinition* fReplayParticle; // and its definition
+  G4bool   fReplayWrapped;    // stream shorter than the run, warned once
+  NuEvent* fNuEvent;          // buffer of the current neutrino interaction
+  G4bool   fNuEventsEnded;    // neutrino file exhausted, warned once
+  G4bool   fPhaseSpaceWrapped; // phase space shorter than the run, warned once
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,100 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PrimaryStream.hh
+/// \brief Definition of the primary stream file classes
+
+#ifndef PrimaryStream_h
+#define PrimaryStream_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+
+/// One pre-generated primary: the kinematics GeneratePrimaries() gives to
+/// the particle gun, 32 bytes on file.
+
+struct PrimaryRecord
+{
+  std::int32_t pdg;
+  float        energy;     // kinetic energy in GeV
+  float        x, y;       // transverse position in cm
+  float        dx, dy, dz; // unit momentum direction
+  float        weight;     // event weight
+};
+
+/// Writer of a primary stream file: a 32-byte header (magic, version,
+/// record size, number of records) followed by the raw records.
+
+class PrimaryStreamWriter
+{
+  public:
+    PrimaryStreamWriter();
+    ~PrimaryStreamWriter();
+
+    G4bool Open(const G4String& fileName);
+    void   Write(const PrimaryRecord& record);
+    void   Close();
+
+    std::uint64_t GetNofRecords() const { return fNofRecords; }
+
+  private:
+    std::ofstream fOutput;
+    std::uint64_t fNofRecords;
+};
+
+/// Read-only memory map of a primary stream file.
+///
+/// The records are accessed in place by index: the file is neither parsed
+/// nor copied, and the map is shared by all threads without locking since
+/// nothing in it is ever modified.
+
+class PrimaryStreamReader
+{
+  public:
+    PrimaryStreamReader();
+    ~PrimaryStreamReader();
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    std::uint64_t GetNofRecords() const { return fNofRecords; }
+    const PrimaryRecord& GetRecord(std::uint64_t i) const { return fRecords[i]; }
+    const G4String& GetFileName() const { return fFileName; }
+
+  private:
+    G4String             fFileName;
+    void*                fMap;
+    std::size_t          fMapSize;
+    const PrimaryRecord* fRecords;
+    std::uint64_t        fNofRecords;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProcessRegistry.hh
+/// \brief Definition of the ProcessRegistry class
+
+#ifndef ProcessRegistry_h
+#define ProcessRegistry_h 1
+
+#include "globals.hh"
+
+#include <unordered_map>
+#include <vector>
+
+class G4VProcess;
+
+/// Small integer identifiers of the processes, stored in the hits instead
+/// of the process names.
+///
+/// Build() is called at the start of run, when the physics tables exist,
+/// and maps every process of every particle of this thread to the rank of
+/// its name among all the process names. The identifiers therefore agree
+/// between threads although the process objects differ. Identifier 0 is
+/// "none", for a step limited by no process or a process unknown at the
+/// start of run. The string table can be written with the hits, once per
+/// output file, by FillNtuple().
+
+class ProcessRegistry
+{
+  public:
+    ProcessRegistry();
+    ~ProcessRegistry();
+
+    void Build();
+
+    G4int GetId(const G4VProcess* process);
+    const G4String& GetName(G4int id) const { return fNames[id]; }
+    std::size_t GetNofProcesses() const { return fNames.size(); }
+
+    void FillNtuple(G4int ntupleId) const;
+
+  private:
+    std::unordered_map<const G4VProcess*, G4int> fIds;
+    std::vector<G4String> fNames;   // by id
+    const G4VProcess* fLastProcess;
+    G4int             fLastId;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int ProcessRegistry::GetId(const G4VProcess* process)
+{
+  // a film is mostly entered by transportation
+  if ( process == fLastProcess ) return fLastId;
+  auto it = fIds.find(process);
+  fLastProcess = process;
+  fLastId = ( it != fIds.end() ) ? it->second : 0;
+  return fLastId;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
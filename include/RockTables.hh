@@ -0,0 +1,113 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RockTables.hh
+/// \brief Definition of the RockTables class
+
+#ifndef RockTables_h
+#define RockTables_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class HistogramSampler;
+
+/// Tables of the muon transport through the rock, used by RockTransportModel
+/// in place of the full simulation.
+///
+/// They are binned in log10 of the muon kinetic energy at the rock entry
+/// (1 GeV to 10 TeV, 10 bins per decade) and hold per energy bin:
+/// - the fraction of muons stopped in the rock,
+/// - the distribution of the exit to entry energy ratio of the others,
+///   with the mean path length it was measured on,
+/// - the distribution of the deflection angle times the entry energy,
+/// - for each species of kSpecies, the mean number of secondaries leaving
+///   the rock per muon and the distribution of log10 of their energy
+///   over the muon entry energy.
+///
+/// The calibration mode fills them from full simulation; as an accumulable
+/// the tables of the worker threads are merged at the end of run and the
+/// master writes them to a text file. Read() loads such a file and builds
+/// the samplers, which are then shared read-only by the worker threads.
+
+class RockTables : public G4VAccumulable
+{
+  public:
+    RockTables();
+    virtual ~RockTables();
+
+    // calibration, from full simulation
+    void FillMuon(G4double entryEnergy, G4double path,
+                  G4double exitEnergy, G4double angle);
+    void FillSecondary(G4double entryEnergy, G4int pdg, G4double energy);
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    // text file, Read() builds the samplers
+    G4bool Write(const G4String& fileName) const;
+    G4bool Read(const G4String& fileName);
+
+    // sampling, for a muon entering with the given energy; Covers() tells
+    // whether the calibration has enough muons at this energy
+    G4bool   Covers(G4double entryEnergy) const;
+    G4double ShootExitEnergy(G4double entryEnergy, G4double path) const;  // 0 if stopped
+    G4double ShootAngle(G4double entryEnergy, G4double path) const;
+    G4int    ShootNofSecondaries(G4double entryEnergy, G4int species) const;
+    G4double ShootSecondaryEnergy(G4double entryEnergy, G4int species) const;
+
+    // get methods
+    static G4int GetNofSpecies();
+    static G4int GetSpeciesPDG(G4int species);
+    G4double GetNofMuons() const;
+
+  private:
+    RockTables(const RockTables&) = delete;
+    RockTables& operator=(const RockTables&) = delete;
+
+    G4int GetEnergyBin(G4double entryEnergy) const;
+    void  DeleteSamplers();
+    void  BuildSamplers();
+
+    // counts per energy bin, histograms per energy bin (and species)
+    std::vector<G4double> fMuons;
+    std::vector<G4double> fStopped;
+    std::vector<G4double> fPathSum;     // mm, of the muons leaving the rock
+    std::vector<G4double> fRatio;       // exit/entry energy
+    std::vector<G4double> fAngle;       // mrad*GeV
+    std::vector<G4double> fYield;       // secondaries per species
+    std::vector<G4double> fSecondary;   // log10 of the energy fraction
+
+    std::vector<HistogramSampler*> fRatioSamplers;
+    std::vector<HistogramSampler*> fAngleSamplers;
+    std::vector<HistogramSampler*> fSecondarySamplers;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
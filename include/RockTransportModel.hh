@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RockTransportModel.hh
+/// \brief Definition of the RockTransportModel class
+
+#ifndef RockTransportModel_h
+#define RockTransportModel_h 1
+
+#include "G4VFastSimulationModel.hh"
+#include "globals.hh"
+
+class DetectorConstruction;
+
+/// Fast simulation of the muons crossing the rock, attached to the Rock
+/// region and active in the fast rock mode (/FASERnu/rock/mode fast).
+///
+/// A muon entering the rock with an energy covered by the RockTables is
+/// moved in one step to the far side of the rock along its direction: the
+/// exit energy, the stopping probability and the deflection angle are
+/// drawn from the tables, the lateral displacement is taken as half the
+/// path times the angle in the deflection plane, and the secondaries
+/// leaving the rock are emitted at the exit point along the muon. The
+/// energy not carried out is deposited locally. Other muons are left to
+/// the full simulation.
+
+class RockTransportModel : public G4VFastSimulationModel
+{
+  public:
+    RockTransportModel(const G4String& name, G4Region* envelope,
+                       const DetectorConstruction* detector);
+    virtual ~RockTransportModel();
+
+    virtual G4bool IsApplicable(const G4ParticleDefinition& particle);
+    virtual G4bool ModelTrigger(const G4FastTrack& fastTrack);
+    virtual void   DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep);
+
+  private:
+    const DetectorConstruction* fDetector;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -31,9 +31,21 @@
 #define RunAction_h 1
 
 #include "G4UserRunAction.hh"
+#include "G4Accumulable.hh"
+#include "G4Timer.hh"
 #include "globals.hh"
 
+#include "HistogramBuffer.hh"
+#include "RockTables.hh"
+#include "SpeciesCounter.hh"
+#include "StepProfiler.hh"
+#include "StepFilter.hh"
+
+#include <vector>
+
 class G4Run;
+class G4GenericMessenger;
+class ScoringPlanes;
 
 /// Run action class
 ///
@@ -50,15 +62,58 @@ class G4Run;
 /// In EndOfRunAction(), the accumulated statistic and computed 
 /// dispersion is printed.
 ///
+/// The master also merges and reports what the threads accumulate for
+/// the run: step and hit counts, the flux of the ScoringPlanes, the rock
+/// tables and range rejections, and the step profile.
+///
 
 class RunAction : public G4UserRunAction
 {
   public:
-    RunAction();
+    RunAction(const ScoringPlanes* scoringPlanes);
     virtual ~RunAction();
 
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
+
+    void CountStep() { fNofSteps += 1; }
+    void CountHits(G4long nofHits, G4long nofSteps)
+    { fNofHits += nofHits; fNofHitSteps += nofSteps; }
+    G4bool IsRockCalibration() const { return fRockCalibration; }
+    RockTables& GetRockTables() { return fRockTables; }
+    StepFilter& GetStepFilter() { return fStepFilter; }
+    HistogramBuffer& GetHistograms() { return fHistograms; }
+    SpeciesCounter& GetRangeKills() { return fRangeKills; }
+    // null unless profiling
+    StepProfiler* GetStepProfiler() { return fProfileSteps ? &fStepProfiler : nullptr; }
+
+  private:
+    void BookFlux(const G4String& plane);
+    void ValidateRock(const G4Run* run, G4bool fast);
+
+    const ScoringPlanes*  fScoringPlanes;
+    std::size_t           fNofBookedPlanes;
+    std::vector<G4int>    fFluxFirstIds;   // per scoring plane, booked on first use
+
+    G4Accumulable<G4long> fNofSteps;      // for the throughput in steps/s
+    G4Accumulable<G4long> fNofHits;       // emulsion hits
+    G4Accumulable<G4long> fNofHitSteps;   // and the steps recorded in them
+    G4Timer               fTimer;
+    RockTables            fRockTables;    // filled when calibrating the rock
+    StepFilter            fStepFilter;    // resolved at each start of run
+    HistogramBuffer       fHistograms;    // flux, flushed at the end of run
+    SpeciesCounter        fRangeKills;    // by the StackingAction
+    StepProfiler          fStepProfiler;  // fed when profiling
+    G4GenericMessenger*   fMessenger;     // /FASERnu/profile/, broadcast
+    G4bool                fProfileSteps;
+    G4String              fProfileFile;
+    G4int                 fProfileRows;
+    G4int                 fProcessNtupleId;  // booked with the hit ntuple
+    G4bool                fRockCalibration;
+    // full simulation flux per event and its variance, per histogram bin,
+    // which the fast rock runs are validated against
+    std::vector<std::vector<G4double> > fFluxReference;
+    std::vector<std::vector<G4double> > fFluxVariance;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ScoringPlanes.hh
+/// \brief Definition of the ScoringPlanes class
+
+#ifndef ScoringPlanes_h
+#define ScoringPlanes_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+class ScoringMessenger;
+
+/// Table of the flux scoring planes shared by all threads.
+///
+/// A plane is a boundary between two logical volumes, crossed from the
+/// first into the second, optionally restricted to one copy number of the
+/// mother of the second volume (the layer for the calorimeter volumes).
+/// The first plane, "absorber", is the gap to absorber boundary of the
+/// original scoring; more are declared with /FASERnu/scoring/addPlane on
+/// the master. Each plane gets its own set of the 28 particle class
+/// histograms, booked by RunAction at the next run in the order of the
+/// table, and is resolved to volume pointers by StepFilter.
+///
+/// Planes can be added between runs but not removed, as the histograms of
+/// the booked ones stay.
+
+class ScoringPlanes
+{
+  public:
+    ScoringPlanes();
+    ~ScoringPlanes();
+
+    struct Plane {
+      G4String name;
+      G4String preVolume;
+      G4String postVolume;
+      G4int    copyNo;   // of the mother of the post volume, -1 for any
+    };
+
+    G4bool AddPlane(const G4String& name, const G4String& preVolume,
+                    const G4String& postVolume, G4int copyNo = -1);
+    void List() const;
+
+    std::size_t GetNofPlanes() const { return fPlanes.size(); }
+    const Plane& GetPlane(std::size_t i) const { return fPlanes[i]; }
+
+  private:
+    ScoringMessenger*  fMessenger;
+    std::vector<Plane> fPlanes;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,188 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceManager.hh
+/// \brief Definition of the SourceManager class
+
+#ifndef SourceManager_h
+#define SourceManager_h 1
+
+#include "globals.hh"
+
+#include <map>
+#include <vector>
+
+class G4ParticleDefinition;
+class HistogramSampler;
+class SourceMessenger;
+class PrimaryStreamReader;
+class NuEventReader;
+class PhaseSpaceWriter;
+class PhaseSpaceReader;
+class BeamProfile;
+struct PrimaryRecord;
+
+/// Table of primary sources shared by all worker threads.
+///
+/// A source is a particle species with its energy spectrum, read from a
+/// two column text file (bin centre in GeV, flux per bin) such as
+/// negmuonFASERforXin.txt. Each event picks one source with a probability
+/// proportional to its integrated flux, so mu+ and mu- can be produced in
+/// the same run.
+///
+/// The table is filled from macro commands (see SourceMessenger) on the
+/// master thread before a run, the samplers are built once at that time
+/// and are only read by the workers during the run.
+/// When no source is defined the generator keeps its default mu- spectrum.
+///
+/// Sources can also be given as a species mixture table, one line per
+/// species with its PDG code (or name), fraction, spectrum and transverse
+/// profile, so that electron or hadron backgrounds use the same generator.
+/// The particle definitions are resolved once when the table is read and
+/// each event dispatches on the index drawn by the source sampler.
+/// The profile is the flat window, a pencil beam on the axis or a binned
+/// beam profile map (see BeamProfile.hh); a map with an energy axis gives
+/// (E, x, y) jointly and then replaces the spectrum and the energy bias.
+///
+/// The energy can be importance sampled: each bin probability is multiplied
+/// by a user bias function b(E) of the bin centre and the event gets the
+/// weight p/q of its bin, so weighted histograms stay unbiased while the
+/// favoured part of the spectrum (e.g. the high energy tail) gets more events.
+///
+/// Primaries can also be written in advance to a binary stream file
+/// (see PrimaryStream.hh) and replayed from a read-only memory map instead
+/// of being sampled.
+///
+/// Finally, externally generated neutrino interactions can be read from a
+/// HepMC or binary event file (see NuEventFile.hh); they take precedence
+/// over the replay and the sources.
+///
+/// For two-stage simulations the particles crossing from the Gap into the
+/// first absorber can be recorded to a phase space file (stage 1, see
+/// PhaseSpaceFile.hh), and such a file replayed at the calorimeter face
+/// (stage 2), one recorded event per event, skipping the rock transport.
+/// The phase space replay comes after the neutrino interactions and
+/// before the primary stream.
+
+class SourceManager
+{
+  public:
+    enum Profile { kFlat, kPencil, kMap };
+
+    struct Source {
+      G4String                    fileName;    // of the spectrum
+      G4ParticleDefinition*       particle;
+      const HistogramSampler*     spectrum;    // energy in GeV
+      Profile                     profile;     // transverse position
+      const BeamProfile*          beamProfile; // map of a kMap profile
+      G4double                    weight;      // integrated flux or fraction
+      HistogramSampler*           biased;      // spectrum times bias, if any
+      std::vector<G4double>       binWeights;  // event weight per biased bin
+    };
+
+    SourceManager();
+    ~SourceManager();
+
+    // set methods
+    G4bool AddSpectrum(const G4String& fileName, const G4String& particleName);
+    G4bool AddSource(const G4String& particleName, G4double fraction,
+                     const G4String& spectrum, const G4String& profile);
+    G4bool ReadSources(const G4String& fileName);
+    void   Clear();
+    G4bool OpenReplay(const G4String& fileName);
+    void   CloseReplay();
+    G4bool SetEnergyBias(const G4String& expression);
+    G4bool OpenNuEvents(const G4String& fileName);
+    void   CloseNuEvents();
+    G4bool RecordPhaseSpace(const G4String& fileName, G4bool killAtBoundary);
+    void   StopRecording();
+    G4bool OpenPhaseSpace(const G4String& fileName);
+    void   ClosePhaseSpace();
+
+    // get methods
+    G4int GetNofSources() const;
+    const Source& GetSource(G4int i) const;
+    const PrimaryStreamReader* GetReplay() const;
+    // thread safe, the workers take events from it concurrently
+    NuEventReader* GetNuEvents() const;
+    // thread safe, the workers write their events to it concurrently
+    PhaseSpaceWriter* GetPhaseSpaceOutput() const;
+    const PhaseSpaceReader* GetPhaseSpace() const;
+
+    // sample the kinematics of one primary with the engine of this thread
+    G4ParticleDefinition* Sample(PrimaryRecord& primary) const;
+    G4bool WritePrimaries(const G4String& fileName, G4int nofPrimaries) const;
+    static G4bool ConvertNuEvents(const G4String& inputName,
+                                  const G4String& outputName);
+
+    void List() const;
+
+    // default mu- energy spectrum (GeV), shared by all threads
+    static const HistogramSampler& GetDefaultMuonSpectrum();
+
+  private:
+    static G4ParticleDefinition* FindParticle(const G4String& particleName);
+    G4bool InsertSource(G4ParticleDefinition* particle, G4double weight,
+                        const G4String& spectrum, Profile profile,
+                        const BeamProfile* beamProfile = nullptr);
+    const BeamProfile* GetBeamProfile(const G4String& fileName);
+    static G4bool ReadSpectrum(const G4String& fileName,
+                               std::vector<G4double>& binEdges,
+                               std::vector<G4double>& binWeights);
+    void BuildSourceSampler();
+    G4bool RebuildBias();
+    G4bool BuildBias(Source& source) const;
+    void ClearBias(Source& source) const;
+
+    std::vector<Source> fSources;
+    std::map<G4String, BeamProfile*> fBeamProfiles; // maps by file name
+    Source              fDefaultSource; // mu- with the default spectrum
+    G4String            fBiasExpression;
+    HistogramSampler*   fSourceSampler; // picks a source by its weight
+    PrimaryStreamReader* fReplay;       // mapped primary stream, if any
+    NuEventReader*      fNuEvents;      // neutrino event file, if any
+    PhaseSpaceWriter*   fPhaseSpaceOutput; // stage-1 recording, if any
+    PhaseSpaceReader*   fPhaseSpace;    // mapped stage-2 phase space, if any
+    SourceMessenger*    fMessenger;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int SourceManager::GetNofSources() const { return fSources.size(); }
+inline const SourceManager::Source& SourceManager::GetSource(G4int i) const
+{ return fSources[i]; }
+inline const PrimaryStreamReader* SourceManager::GetReplay() const
+{ return fReplay; }
+inline NuEventReader* SourceManager::GetNuEvents() const
+{ return fNuEvents; }
+inline PhaseSpaceWriter* SourceManager::GetPhaseSpaceOutput() const
+{ return fPhaseSpaceOutput; }
+inline const PhaseSpaceReader* SourceManager::GetPhaseSpace() const
+{ return fPhaseSpace; }
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceMessenger.hh
+/// \brief Definition of the SourceMessenger class
+
+#ifndef SourceMessenger_h
+#define SourceMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class SourceManager;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithAString;
+
+/// Messenger of the SourceManager, commands in /FASERnu/gun/.
+///
+/// The commands are executed on the master thread only, the workers read
+/// the resulting source table.
+
+class SourceMessenger : public G4UImessenger
+{
+  public:
+    SourceMessenger(SourceManager* manager);
+    virtual ~SourceMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    SourceManager*           fManager;
+
+    G4UIdirectory*           fGunDir;
+    G4UIcommand*             fAddSpectrumCmd;
+    G4UIcommand*             fAddSourceCmd;
+    G4UIcmdWithAString*      fReadSourcesCmd;
+    G4UIcmdWithoutParameter* fClearCmd;
+    G4UIcmdWithoutParameter* fListCmd;
+    G4UIcommand*             fWriteCmd;
+    G4UIcmdWithAString*      fReplayCmd;
+    G4UIcmdWithoutParameter* fStopReplayCmd;
+    G4UIcmdWithAString*      fBiasCmd;
+    G4UIcmdWithAString*      fNuEventsCmd;
+    G4UIcmdWithoutParameter* fStopNuEventsCmd;
+    G4UIcommand*             fConvertNuEventsCmd;
+    G4UIcommand*             fRecordPhaseSpaceCmd;
+    G4UIcmdWithoutParameter* fStopRecordingCmd;
+    G4UIcmdWithAString*      fPhaseSpaceCmd;
+    G4UIcmdWithoutParameter* fStopPhaseSpaceCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,73 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SpeciesCounter.hh
+/// \brief Definition of the SpeciesCounter class
+
+#ifndef SpeciesCounter_h
+#define SpeciesCounter_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <map>
+
+/// Per-species counts of the tracks seen and rejected by a selection, with
+/// the kinetic energy of the rejected ones, merged from the worker threads
+/// at the end of run. All ions are counted together under kIons.
+
+class SpeciesCounter : public G4VAccumulable
+{
+  public:
+    SpeciesCounter(const G4String& name);
+    virtual ~SpeciesCounter();
+
+    static const G4int kIons = 1000000000;
+
+    void Count(G4int pdg) { ++fCounts[Key(pdg)].nofTracks; }
+    void CountRejected(G4int pdg, G4double energy);
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    // one line per species, energy in GeV
+    void Print() const;
+    G4long GetNofRejected() const;
+
+  private:
+    static G4int Key(G4int pdg) { return ( pdg > kIons ) ? kIons : pdg; }
+
+    struct Counts {
+      G4long   nofTracks;
+      G4long   nofRejected;
+      G4double rejectedEnergy;
+    };
+    std::map<G4int, Counts> fCounts;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
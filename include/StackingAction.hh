@@ -0,0 +1,75 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.hh
+/// \brief Definition of the StackingAction class
+
+#ifndef StackingAction_h
+#define StackingAction_h 1
+
+#include "G4UserStackingAction.hh"
+#include "G4EmCalculator.hh"
+#include "globals.hh"
+
+class RunAction;
+
+/// Stacking action class
+///
+/// With the range rejection on (/FASERnu/rock/rangeKill), a charged
+/// secondary born in the rock is killed when its range, plus a margin
+/// (/FASERnu/rock/rangeMargin), is shorter than its distance to the rock
+/// surface in any direction: it cannot leave the rock, and outside it
+/// there is only vacuum up to the calorimeter. The range is the one of the
+/// restricted dE/dx tables of the Rock region, never shorter than the
+/// CSDA range.
+///
+/// The margin is the only protection for the neutral particles the killed
+/// track would have emitted (bremsstrahlung, annihilation photons), so
+/// particles which decay or annihilate into penetrating ones (unstable
+/// particles, antibaryons) are never killed; nuclei always are.
+///
+/// The charged secondaries in the rock and the killed ones are counted
+/// per species in the SpeciesCounter of the RunAction.
+
+class StackingAction : public G4UserStackingAction
+{
+  public:
+    StackingAction(RunAction* runAction);
+    virtual ~StackingAction();
+
+    virtual G4ClassificationOfNewTrack ClassifyNewTrack(const G4Track* track);
+    virtual void PrepareNewEvent();
+
+  private:
+    RunAction*     fRunAction;
+    G4EmCalculator fEmCalculator;
+    G4bool         fRangeKill;
+    G4double       fRangeMargin;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,129 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepFilter.hh
+/// \brief Definition of the StepFilter class
+
+#ifndef StepFilter_h
+#define StepFilter_h 1
+
+#include "G4ParticleDefinition.hh"
+#include "G4StepPoint.hh"
+#include "G4VTouchable.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4LogicalVolume;
+class ScoringPlanes;
+
+/// Step selections of SteppingAction resolved once per run.
+///
+/// Resolve() looks up the Rock, Gap and absorber logical volumes in the
+/// store, as their pointers change when the geometry is rebuilt, so that
+/// a step is matched with pointer compares instead of name compares.
+/// The flux histogram of a particle (2-28, 0 if none, see RunAction) is
+/// kept in a table indexed by the particle definition ID; the ions created
+/// during the run are classified when first met.
+///
+/// The volumes of the ScoringPlanes are resolved the same way, with the id
+/// of the first histogram booked for each plane; without a table only the
+/// absorber plane is defined.
+
+class StepFilter
+{
+  public:
+    StepFilter();
+    ~StepFilter();
+
+    // the number of planes whose volumes are not found
+    G4int Resolve(const ScoringPlanes* planes = nullptr,
+                  const std::vector<G4int>& firstHistoIds = std::vector<G4int>());
+
+    // the flux crossing from the gap into the absorber
+    G4bool IsFluxCrossing(const G4LogicalVolume* pre,
+                          const G4LogicalVolume* post) const
+    { return pre == fGapLV && post == fAbsoLV; }
+
+    G4bool IsRock(const G4LogicalVolume* volume) const
+    { return volume == fRockLV; }
+    G4bool IsGap(const G4LogicalVolume* volume) const
+    { return volume == fGapLV; }
+
+    // scoring planes
+    std::size_t GetNofPlanes() const { return fPlanes.size(); }
+    G4bool IsOnPlane(std::size_t plane, const G4LogicalVolume* pre,
+                     const G4LogicalVolume* post, const G4StepPoint* postPoint) const;
+    G4int GetFirstHistoId(std::size_t plane) const { return fPlanes[plane].firstHistoId; }
+
+    // histogram of a secondary particle
+    G4int GetHistoId(const G4ParticleDefinition* particle);
+
+    // the classification as done per step before the table
+    static G4int Classify(const G4ParticleDefinition* particle);
+
+  private:
+    struct Plane {
+      const G4LogicalVolume* preVolume;
+      const G4LogicalVolume* postVolume;
+      G4int                  copyNo;
+      G4int                  firstHistoId;
+    };
+
+    const G4LogicalVolume* fRockLV;
+    const G4LogicalVolume* fGapLV;
+    const G4LogicalVolume* fAbsoLV;
+    std::vector<G4int>     fHistoIds;   // per definition ID, -1 if not yet known
+    std::vector<Plane>     fPlanes;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4bool StepFilter::IsOnPlane(std::size_t plane,
+                                    const G4LogicalVolume* pre,
+                                    const G4LogicalVolume* post,
+                                    const G4StepPoint* postPoint) const
+{
+  const Plane& scoring = fPlanes[plane];
+  if ( pre != scoring.preVolume || post != scoring.postVolume ) return false;
+  return scoring.copyNo < 0
+      || postPoint->GetTouchable()->GetCopyNumber(1) == scoring.copyNo;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int StepFilter::GetHistoId(const G4ParticleDefinition* particle)
+{
+  G4int id = particle->GetParticleDefinitionID();
+  if ( id < 0 ) return Classify(particle);
+  if ( std::size_t(id) >= fHistoIds.size() ) fHistoIds.resize(id+1, -1);
+  if ( fHistoIds[id] < 0 ) fHistoIds[id] = Classify(particle);
+  return fHistoIds[id];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,110 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepProfiler.hh
+/// \brief Definition of the StepProfiler class
+
+#ifndef StepProfiler_h
+#define StepProfiler_h 1
+
+#include "G4VAccumulable.hh"
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+
+/// Steps, tracks and wall time per (logical volume, particle, process).
+///
+/// A step is counted, with the time since the end of the previous step of
+/// its track (or the start of the track), under its volume, particle and
+/// the process which limited it. A track is counted under the volume
+/// where it starts, its particle and the process which created it.
+///
+/// The counts of a thread are keyed by the volume, particle and process
+/// pointers; Merge() gathers them by names, as the processes differ from
+/// one thread to another, so the master reports the whole run.
+
+class StepProfiler : public G4VAccumulable
+{
+  public:
+    StepProfiler();
+    virtual ~StepProfiler();
+
+    void BeginTrack(const G4Track* track);
+    void EndStep(const G4Step* step);
+
+    virtual void Merge(const G4VAccumulable& other);
+    virtual void Reset();
+
+    // rows sorted by decreasing time
+    void Print(G4int nofRows) const;
+    G4bool Write(const G4String& fileName) const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Key {
+      const void* volume;
+      const void* particle;
+      const void* process;
+      bool operator==(const Key& other) const
+      { return volume == other.volume && particle == other.particle
+               && process == other.process; }
+    };
+    struct KeyHash {
+      std::size_t operator()(const Key& key) const;
+    };
+    struct Counts {
+      G4long   nofSteps;
+      G4long   nofTracks;
+      G4double time;   // s
+    };
+    using Names = std::tuple<G4String, G4String, G4String>;
+    struct Row {
+      Names  names;
+      Counts counts;
+    };
+
+    Counts& GetCounts(const Key& key);
+    void AddByNames(std::map<Names, Counts>& to) const;
+    std::vector<Row> GetRows() const;
+
+    std::unordered_map<Key, Counts, KeyHash> fCounts;   // this thread
+    std::map<Names, Counts>                  fMerged;   // of the other threads
+    Key               fLastKey;
+    Counts*           fLastCounts;
+    Clock::time_point fLastTime;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
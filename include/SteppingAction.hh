@@ -34,17 +34,38 @@
 #define SteppingAction_h 1
 
 #include "G4UserSteppingAction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+class RunAction;
+class EventAction;
+class StepFilter;
+class HistogramBuffer;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 class SteppingAction : public G4UserSteppingAction
 {
   public:
-   SteppingAction();
+   SteppingAction(RunAction* runAction, EventAction* eventAction);
   ~SteppingAction();
 
    virtual void UserSteppingAction(const G4Step*);
+
+  private:
+   void ScoreCrossing(const G4Step* step, std::size_t plane);
+   void CalibrateRock(const G4Step* step);
+
+   RunAction*       fRunAction;
+   EventAction*     fEventAction;
+   StepFilter*      fStepFilter;
+   HistogramBuffer* fHistograms;
+
+   // primary muon at the rock entry, for the calibration
+   G4double      fRockEntryEnergy;
+   G4ThreeVector fRockEntryPosition;
+   G4ThreeVector fRockEntryDirection;
+   G4bool        fRockMuonDone;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
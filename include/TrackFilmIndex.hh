@@ -0,0 +1,104 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TrackFilmIndex.hh
+/// \brief Definition of the TrackFilmIndex class
+
+#ifndef TrackFilmIndex_h
+#define TrackFilmIndex_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Hit of each (track, layer, film) of an event, for the aggregation of the
+/// emulsion hits per track and film in CalorimeterSD.
+///
+/// A small open-addressing hash table with linear probing, keyed by the
+/// packed track ID, layer and film. Clear() only bumps the generation of
+/// the table, so an event costs nothing to forget; the slots of earlier
+/// generations count as empty. The table doubles when half full and keeps
+/// its size from event to event.
+
+class TrackFilmIndex
+{
+  public:
+    TrackFilmIndex(std::size_t nofSlots = 1024);
+    ~TrackFilmIndex();
+
+    static G4long GetKey(G4int trackID, G4int layer, G4int film)
+    { return ( G4long(trackID) << 32 ) | ( G4long(layer) << 1 ) | film; }
+
+    void Clear();
+
+    // the hit of the key, or hit if the key is new (inserted set to true)
+    std::size_t FindOrInsert(G4long key, std::size_t hit, G4bool& inserted);
+
+    std::size_t GetSize() const { return fSize; }
+
+  private:
+    struct Slot {
+      G4long        key;
+      std::size_t   hit;
+      G4int         generation;
+    };
+
+    static std::size_t Hash(G4long key)
+    { return std::size_t((unsigned long long)(key) * 0x9E3779B97F4A7C15ULL >> 32); }
+    void Grow();
+
+    std::vector<Slot> fSlots;
+    std::size_t       fMask;
+    std::size_t       fSize;
+    G4int             fGeneration;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline std::size_t TrackFilmIndex::FindOrInsert(G4long key, std::size_t hit,
+                                                G4bool& inserted)
+{
+  if ( 2*(fSize+1) > fSlots.size() ) Grow();
+  for (std::size_t i = Hash(key) & fMask; ; i = (i+1) & fMask) {
+    Slot& slot = fSlots[i];
+    if ( slot.generation != fGeneration ) {
+      slot.key = key;
+      slot.hit = hit;
+      slot.generation = fGeneration;
+      ++fSize;
+      inserted = true;
+      return hit;
+    }
+    if ( slot.key == key ) {
+      inserted = false;
+      return slot.hit;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -36,16 +36,24 @@
 #include "G4UserTrackingAction.hh"
 #include "globals.hh"
 
+class RunAction;
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+/// Tracking action class
+///
+/// It starts the accounting of a track in the StepProfiler when profiling.
+
 class TrackingAction : public G4UserTrackingAction {
 
   public:  
-    TrackingAction();
+    TrackingAction(RunAction* runAction);
    ~TrackingAction() {};
    
-  //virtual void  PreUserTrackingAction(const G4Track*);   
-    virtual void PostUserTrackingAction(const G4Track*);
+    virtual void  PreUserTrackingAction(const G4Track*);   
+
+  private:
+    RunAction* fRunAction;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
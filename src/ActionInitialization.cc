@@ -31,36 +31,54 @@
 #include "PrimaryGeneratorAction.hh"
 #include "RunAction.hh"
 #include "EventAction.hh"
+#include "StackingAction.hh"
 #include "TrackingAction.hh"
 #include "SteppingAction.hh"
+#include "SourceManager.hh"
+#include "EventSeeder.hh"
+#include "ScoringPlanes.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 ActionInitialization::ActionInitialization()
- : G4VUserActionInitialization()
-{}
+ : G4VUserActionInitialization(),
+   fSourceManager(nullptr),
+   fEventSeeder(nullptr),
+   fScoringPlanes(nullptr)
+{
+  fSourceManager = new SourceManager();
+  fEventSeeder = new EventSeeder();
+  fScoringPlanes = new ScoringPlanes();
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 ActionInitialization::~ActionInitialization()
-{}
+{
+  delete fSourceManager;
+  delete fEventSeeder;
+  delete fScoringPlanes;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void ActionInitialization::BuildForMaster() const
 {
-  SetUserAction(new RunAction);
+  SetUserAction(new RunAction(fScoringPlanes));
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void ActionInitialization::Build() const
 {
-  SetUserAction(new PrimaryGeneratorAction);
-  SetUserAction(new RunAction);
-  SetUserAction(new EventAction);
-  //SetUserAction(new TrackingAction);
-  SetUserAction(new SteppingAction);
+  SetUserAction(new PrimaryGeneratorAction(fSourceManager, fEventSeeder));
+  auto runAction = new RunAction(fScoringPlanes);
+  SetUserAction(runAction);
+  auto eventAction = new EventAction(runAction, fSourceManager);
+  SetUserAction(eventAction);
+  SetUserAction(new StackingAction(runAction));
+  SetUserAction(new TrackingAction(runAction));
+  SetUserAction(new SteppingAction(runAction, eventAction));
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
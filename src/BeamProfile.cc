@@ -0,0 +1,134 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file BeamProfile.cc
+/// \brief Implementation of the BeamProfile class
+
+#include "BeamProfile.hh"
+#include "HistogramSampler.hh"
+
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BeamProfile::BeamProfile()
+ : fFileName(""),
+   fX{0, 0., 0.},
+   fY{0, 0., 0.},
+   fE{0, 0., 0.},
+   fCells(nullptr)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+BeamProfile::~BeamProfile()
+{
+  delete fCells;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool BeamProfile::Read(const G4String& fileName)
+{
+  std::ifstream input(fileName);
+  if ( ! input.is_open() ) return false;
+
+  // axis lines first, then the cell weights
+  Axis x{0, 0., 0.}, y{0, 0., 0.}, e{0, 0., 0.};
+  std::vector<G4double> weights;
+  std::string line;
+  while ( std::getline(input, line) ) {
+    auto hash = line.find('#');
+    if ( hash != std::string::npos ) line.erase(hash);
+    std::istringstream fields(line);
+    std::string key;
+    if ( ! ( fields >> key ) ) continue;
+
+    if ( key == "x" || key == "y" || key == "e" ) {
+      Axis& axis = ( key == "x" ) ? x : ( key == "y" ) ? y : e;
+      G4double min, max;
+      if ( ! ( fields >> axis.nofBins >> min >> max )
+           || axis.nofBins <= 0 || ! ( max > min ) ) return false;
+      axis.min = min;
+      axis.width = (max-min)/axis.nofBins;
+      continue;
+    }
+
+    fields.clear();
+    fields.str(line);
+    G4double weight;
+    while ( fields >> weight ) weights.push_back(weight);
+  }
+
+  if ( x.nofBins == 0 || y.nofBins == 0 ) return false;
+  std::size_t nofCells = std::size_t(x.nofBins)*y.nofBins*std::max(e.nofBins, 1);
+  if ( weights.size() != nofCells ) return false;
+  G4double sum = 0.;
+  for (auto weight : weights) {
+    if ( weight < 0. ) return false;
+    sum += weight;
+  }
+  if ( ! ( sum > 0. ) ) return false;
+
+  std::vector<G4double> edges(nofCells+1);
+  for (std::size_t i = 0; i <= nofCells; ++i) edges[i] = i;
+  delete fCells;
+  fCells = new HistogramSampler(edges, weights);
+  fFileName = fileName;
+  fX = x;
+  fY = y;
+  fE = e;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int BeamProfile::GetNofCells() const
+{
+  return fCells ? fCells->GetNofBins() : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void BeamProfile::Shoot(G4double& x, G4double& y, G4double& energy) const
+{
+  G4int cell = fCells->ShootBin();
+  G4int ix = cell % fX.nofBins;
+  cell /= fX.nofBins;
+  G4int iy = cell % fY.nofBins;
+  G4int ie = cell / fY.nofBins;
+
+  x = fX.min + (ix + G4UniformRand())*fX.width;
+  y = fY.min + (iy + G4UniformRand())*fY.width;
+  if ( fE.nofBins > 0 ) energy = fE.min + (ie + G4UniformRand())*fE.width;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
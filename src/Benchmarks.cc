@@ -0,0 +1,606 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file Benchmarks.cc
+/// \brief Implementation of the Benchmarks class
+
+#include "Benchmarks.hh"
+#include "HistogramSampler.hh"
+#include "SourceManager.hh"
+#include "BeamProfile.hh"
+#include "FieldMap.hh"
+#include "StepFilter.hh"
+#include "CalorimeterSD.hh"
+#include "Analysis.hh"
+
+#include "G4GenericMessenger.hh"
+#include "G4RunManager.hh"
+#include "G4TransportationManager.hh"
+#include "G4Timer.hh"
+#include "G4UniformMagField.hh"
+#include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleTable.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4Navigator.hh"
+#include "G4TouchableHistory.hh"
+#include "G4ProcessManager.hh"
+#include "G4VProcess.hh"
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4DynamicParticle.hh"
+#include "G4VSolid.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // Energy draw as done before the alias sampler: G4RandGeneral followed by
+  // a linear search through the 80 equal-width cells of its output.
+  G4double LegacyEnergyShoot(G4RandGeneral& randGeneral,
+                             const HistogramSampler& spectrum)
+  {
+    G4double rnd = randGeneral.shoot();
+    G4int nofBins = spectrum.GetNofBins();
+    G4int bin = 0;
+    while ( bin < nofBins-1 && rnd >= (bin+1.)/nofBins ) ++bin;
+    return G4RandFlat::shoot(spectrum.GetLowEdge(bin), spectrum.GetHighEdge(bin));
+  }
+
+  // 1 tesla dipole along y in a 60 x 60 x 300 cm box, falling off as cos^2
+  // over the last 50 cm at both ends, on a 2.5 cm grid
+  void MakeSyntheticFieldMap(FieldMap& fieldMap)
+  {
+    const G4int nofPoints[3] = { 25, 25, 121 };
+    const G4double min[3] = { -30.*cm, -30.*cm, -150.*cm };
+    const G4double max[3] = {  30.*cm,  30.*cm,  150.*cm };
+    std::vector<float> values;
+    values.reserve(3*nofPoints[0]*nofPoints[1]*nofPoints[2]);
+    for (G4int k = 0; k < nofPoints[2]; ++k) {
+      G4double z = min[2] + k*(max[2]-min[2])/(nofPoints[2]-1);
+      G4double fringe = std::max(0., std::abs(z) - 100.*cm)/(50.*cm);
+      G4double by = std::pow(std::cos(0.5*CLHEP::pi*fringe), 2);
+      for (G4int j = 0; j < nofPoints[1]; ++j) {
+        for (G4int i = 0; i < nofPoints[0]; ++i) {
+          values.push_back(0.);
+          values.push_back(by);
+          values.push_back(0.);
+        }
+      }
+    }
+    fieldMap.SetGrid(nofPoints, min, max, values);
+  }
+
+  // Boundary step selection as done before the StepFilter: logical volume
+  // names copied and compared, then the particle classified by the chain
+  G4int LegacyStepSelection(const G4LogicalVolume* pre,
+                            const G4LogicalVolume* post,
+                            const G4ParticleDefinition* particle)
+  {
+    G4String name1 = pre->GetName();
+    G4String name2 = post->GetName();
+    if ( !( name1 == "Gap" && name2 == "AbsoLV" ) ) return -1;
+    return StepFilter::Classify(particle);
+  }
+
+  // Emulsion hit as recorded before the staged CalorimeterSD: every
+  // quantity read and the process name copied before the step status is
+  // checked, one heap object per hit, copied to the ntuple columns at the
+  // end of event
+  struct LegacyHit {
+    G4int layer, film, particleID, trackID, parentID;
+    G4double charge, kE1, kE2, edep, length;
+    G4ThreeVector position, momentum;
+    G4String processName;
+  };
+
+  void LegacyProcessHits(const G4Step* step, std::vector<LegacyHit*>& hits)
+  {
+    G4double edep = step->GetTotalEnergyDeposit();
+    if ( edep==0. ) return;
+    const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+    auto touchable = preStepPoint->GetTouchable();
+    auto replicaNumber = touchable->GetReplicaNumber(1);
+    auto copyNumber = touchable->GetCopyNumber();
+    const G4StepStatus status = preStepPoint->GetStepStatus();
+    G4ParticleDefinition* pd = step->GetTrack()->GetDefinition();
+    G4int particleID   = pd->GetPDGEncoding();
+    G4int trackID      = step->GetTrack()->GetTrackID();
+    G4int parentID     = step->GetTrack()->GetParentID();
+    G4double charge    = pd->GetPDGCharge();
+    G4ThreeVector pos  = preStepPoint->GetPosition();
+    G4ThreeVector mom  = preStepPoint->GetMomentum();
+    G4double kE1      = preStepPoint->GetKineticEnergy();
+    G4double kE2      = step->GetPostStepPoint()->GetKineticEnergy();
+    G4double len      = step->GetStepLength();
+    const G4VProcess* proc = step->GetPostStepPoint()->GetProcessDefinedStep();
+    G4String procName = proc ? proc->GetProcessName() : "";
+    if ( status != fGeomBoundary ) return;
+    hits.push_back(new LegacyHit{ replicaNumber, copyNumber, particleID,
+      trackID, parentID, charge, kE1, kE2, edep, len, pos, mom, procName });
+  }
+
+  void LegacyEndOfEvent(std::vector<LegacyHit*>& hits)
+  {
+    for (auto hit : hits) {
+      emulsionHits.Add(hit->layer, hit->film, hit->particleID, hit->trackID,
+                       hit->parentID, hit->charge, hit->position, hit->momentum,
+                       hit->kE1, hit->kE2, hit->edep, hit->length, 0);
+      delete hit;
+    }
+    hits.clear();
+  }
+
+  void PrintResult(const G4String& name, G4int nofCalls, G4double seconds,
+                   G4double check)
+  {
+    G4cout << "  " << std::setw(12) << name << ": "
+           << std::setw(8) << std::setprecision(4) << seconds*1.e9/nofCalls
+           << " ns/call  (check value " << check << ")" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Benchmarks::Benchmarks()
+ : fMessenger(nullptr)
+{
+  fMessenger = new G4GenericMessenger(this, "/FASERnu/bench/",
+                                      "Micro benchmarks");
+
+  auto& samplerCmd
+    = fMessenger->DeclareMethod("energySampler", &Benchmarks::EnergySampler,
+        "Time the primary energy sampler against the legacy G4RandGeneral ladder");
+  samplerCmd.SetParameterName("nofDraws", true);
+  samplerCmd.SetDefaultValue("10000000");
+  samplerCmd.SetToBeBroadcasted(false);
+
+  auto& profileCmd
+    = fMessenger->DeclareMethod("beamProfile", &Benchmarks::BeamProfileSampler,
+        "Time a beam profile map draw against the flat x/y window");
+  profileCmd.SetParameterName(0, "fileName", false);
+  profileCmd.SetParameterName(1, "nofDraws", true);
+  profileCmd.SetDefaultValue(1, "10000000");
+  profileCmd.SetToBeBroadcasted(false);
+
+  auto& fieldCmd
+    = fMessenger->DeclareMethod("fieldMap", &Benchmarks::FieldMapEvaluation,
+        "Time field map evaluations along tracks and at random points against "
+        "the uniform field; synthetic uses a built-in dipole map");
+  fieldCmd.SetParameterName(0, "fileName", true);
+  fieldCmd.SetDefaultValue(0, "synthetic");
+  fieldCmd.SetParameterName(1, "nofEvaluations", true);
+  fieldCmd.SetDefaultValue(1, "10000000");
+  fieldCmd.SetToBeBroadcasted(false);
+
+  auto& filterCmd
+    = fMessenger->DeclareMethod("stepFilter", &Benchmarks::StepFiltering,
+        "Time the boundary step selection by volume pointers and particle "
+        "table against the name compares and classification chain");
+  filterCmd.SetParameterName("nofSteps", true);
+  filterCmd.SetDefaultValue("10000000");
+  filterCmd.SetToBeBroadcasted(false);
+
+  auto& hitsCmd
+    = fMessenger->DeclareMethod("hitRecording", &Benchmarks::HitRecording,
+        "Time the emulsion SD on steps in the films of the geometry with each "
+        "recording policy against the legacy hit objects");
+  hitsCmd.SetParameterName("nofSteps", true);
+  hitsCmd.SetDefaultValue("10000000");
+  hitsCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+Benchmarks::~Benchmarks()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Benchmarks::EnergySampler(G4int nofDraws)
+{
+  if ( nofDraws <= 0 ) return;
+
+  const auto& spectrum = SourceManager::GetDefaultMuonSpectrum();
+  std::vector<G4double> prob(spectrum.GetNofBins());
+  for (G4int i = 0; i < spectrum.GetNofBins(); ++i) {
+    prob[i] = spectrum.GetBinProbability(i);
+  }
+  G4RandGeneral randGeneral(prob.data(), prob.size());
+
+  G4cout << G4endl << "---> Energy sampler benchmark, " << nofDraws
+         << " draws (check value = mean energy in GeV)" << G4endl;
+
+  G4Timer timer;
+  G4double sum = 0.;
+  timer.Start();
+  for (G4int i = 0; i < nofDraws; ++i) sum += LegacyEnergyShoot(randGeneral, spectrum);
+  timer.Stop();
+  G4double legacyTime = timer.GetRealElapsed();
+  PrintResult("ladder", nofDraws, legacyTime, sum/nofDraws);
+
+  sum = 0.;
+  timer.Start();
+  for (G4int i = 0; i < nofDraws; ++i) sum += spectrum.Shoot();
+  timer.Stop();
+  G4double aliasTime = timer.GetRealElapsed();
+  PrintResult("alias", nofDraws, aliasTime, sum/nofDraws);
+
+  if ( aliasTime > 0. ) {
+    G4cout << "  speed-up: " << legacyTime/aliasTime << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Benchmarks::BeamProfileSampler(G4String fileName, G4int nofDraws)
+{
+  if ( nofDraws <= 0 ) return;
+
+  BeamProfile beamProfile;
+  if ( ! beamProfile.Read(fileName) ) {
+    G4cout << "---> Cannot read the beam profile map " << fileName << G4endl;
+    return;
+  }
+
+  G4cout << G4endl << "---> Beam profile benchmark, " << nofDraws << " draws, "
+         << beamProfile.GetNofCells() << " cells"
+         << ( beamProfile.HasEnergy() ? " in (E, x, y)" : " in (x, y)" )
+         << " (check value = mean x in cm)" << G4endl;
+
+  G4Timer timer;
+  G4double sum = 0.;
+  G4double x, y, energy;
+  timer.Start();
+  for (G4int i = 0; i < nofDraws; ++i) {
+    x = G4RandFlat::shoot(-7.50,7.50);
+    y = G4RandFlat::shoot(-6.25,6.25);
+    sum += x;
+  }
+  timer.Stop();
+  G4double flatTime = timer.GetRealElapsed();
+  PrintResult("flat", nofDraws, flatTime, sum/nofDraws);
+
+  sum = 0.;
+  timer.Start();
+  for (G4int i = 0; i < nofDraws; ++i) {
+    beamProfile.Shoot(x, y, energy);
+    sum += x;
+  }
+  timer.Stop();
+  G4double mapTime = timer.GetRealElapsed();
+  PrintResult("map", nofDraws, mapTime, sum/nofDraws);
+
+  if ( flatTime > 0. ) {
+    G4cout << "  map/flat cost: " << mapTime/flatTime << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Benchmarks::FieldMapEvaluation(G4String fileName, G4int nofEvaluations)
+{
+  if ( nofEvaluations <= 0 ) return;
+
+  FieldMap fieldMap;
+  if ( fileName == "synthetic" ) {
+    MakeSyntheticFieldMap(fieldMap);
+  }
+  else if ( ! fieldMap.Read(fileName) ) {
+    G4cout << "---> Cannot read the field map " << fileName << G4endl;
+    return;
+  }
+
+  G4cout << G4endl << "---> Field map benchmark, " << nofEvaluations
+         << " evaluations, " << fieldMap.GetNofPoints() << " grid points"
+         << " (check value = mean By in tesla)" << G4endl;
+
+  // points drawn beforehand so that only the evaluations are timed: along
+  // straight tracks in 1 mm steps, mostly in the cell of the previous
+  // point, and at random in the central 50 x 50 x 250 cm
+  const G4int kNofPoints = 1 << 16;
+  std::vector<G4double> trackPoints(4*kNofPoints);
+  std::vector<G4double> randomPoints(4*kNofPoints);
+  G4double position[3] = { 0., 0., 0. };
+  G4double direction[3] = { 0., 0., 1. };
+  for (G4int i = 0; i < kNofPoints; ++i) {
+    if ( i % 2000 == 0 ) {
+      position[0] = G4RandFlat::shoot(-25.*cm, 25.*cm);
+      position[1] = G4RandFlat::shoot(-25.*cm, 25.*cm);
+      position[2] = -100.*cm;
+      direction[0] = G4RandFlat::shoot(-0.05, 0.05);
+      direction[1] = G4RandFlat::shoot(-0.05, 0.05);
+    }
+    for (G4int c = 0; c < 3; ++c) {
+      position[c] += direction[c]*mm;
+      trackPoints[4*i+c] = position[c];
+    }
+    randomPoints[4*i]   = G4RandFlat::shoot(-25.*cm, 25.*cm);
+    randomPoints[4*i+1] = G4RandFlat::shoot(-25.*cm, 25.*cm);
+    randomPoints[4*i+2] = G4RandFlat::shoot(-125.*cm, 125.*cm);
+  }
+
+  G4UniformMagField uniformField(G4ThreeVector(0., 1.*tesla, 0.));
+  const G4MagneticField* fields[3] = { &uniformField, &fieldMap, &fieldMap };
+  const std::vector<G4double>* points[3]
+    = { &trackPoints, &trackPoints, &randomPoints };
+  const char* names[3] = { "uniform", "map track", "map random" };
+
+  G4Timer timer;
+  G4double field[3];
+  G4double uniformTime = 0.;
+  for (G4int test = 0; test < 3; ++test) {
+    const G4double* point = points[test]->data();
+    G4double sum = 0.;
+    timer.Start();
+    for (G4int i = 0; i < nofEvaluations; ++i) {
+      fields[test]->GetFieldValue(point + 4*(i & (kNofPoints-1)), field);
+      sum += field[1];
+    }
+    timer.Stop();
+    G4double time = timer.GetRealElapsed();
+    PrintResult(names[test], nofEvaluations, time, sum/nofEvaluations/tesla);
+    if ( time > 0. ) {
+      G4cout << "  " << std::setw(12) << "" << "  "
+             << std::setprecision(4) << nofEvaluations/time
+             << " evaluations/s" << G4endl;
+    }
+    if ( test == 0 ) uniformTime = time;
+    else if ( uniformTime > 0. ) {
+      G4cout << "  " << std::setw(12) << "" << "  map/uniform cost: "
+             << time/uniformTime << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Benchmarks::StepFiltering(G4int nofSteps)
+{
+  if ( nofSteps <= 0 ) return;
+
+  StepFilter filter;
+  filter.Resolve();
+  auto store = G4LogicalVolumeStore::GetInstance();
+  auto gap = store->GetVolume("Gap", false);
+  auto absorber = store->GetVolume("AbsoLV", false);
+  if ( ! gap || ! absorber ) {
+    G4cout << "---> Step filter benchmark needs the geometry, run /run/initialize"
+           << G4endl;
+    return;
+  }
+
+  // boundary steps between random volume pairs of the geometry, one in
+  // ten at the flux crossing, with particles of the whole table
+  const G4int kNofSteps = 1 << 16;
+  std::vector<const G4LogicalVolume*> volumes(store->begin(), store->end());
+  std::vector<const G4ParticleDefinition*> particles;
+  auto iterator = G4ParticleTable::GetParticleTable()->GetIterator();
+  iterator->reset();
+  while ( (*iterator)() ) particles.push_back(iterator->value());
+
+  std::vector<const G4LogicalVolume*> preVolumes(kNofSteps), postVolumes(kNofSteps);
+  std::vector<const G4ParticleDefinition*> stepParticles(kNofSteps);
+  for (G4int i = 0; i < kNofSteps; ++i) {
+    if ( G4UniformRand() < 0.1 ) {
+      preVolumes[i] = gap;
+      postVolumes[i] = absorber;
+    }
+    else {
+      preVolumes[i] = volumes[G4int(G4UniformRand()*volumes.size())];
+      postVolumes[i] = volumes[G4int(G4UniformRand()*volumes.size())];
+    }
+    stepParticles[i] = particles[G4int(G4UniformRand()*particles.size())];
+  }
+
+  G4cout << G4endl << "---> Step filter benchmark, " << nofSteps
+         << " boundary steps, " << volumes.size() << " volumes, "
+         << particles.size() << " particles"
+         << " (check value = mean histogram id of the crossings)" << G4endl;
+
+  G4Timer timer;
+  G4double sum = 0.;
+  G4int nofCrossings = 0;
+  timer.Start();
+  for (G4int i = 0; i < nofSteps; ++i) {
+    G4int j = i & (kNofSteps-1);
+    G4int ih = LegacyStepSelection(preVolumes[j], postVolumes[j], stepParticles[j]);
+    if ( ih < 0 ) continue;
+    sum += ih;
+    ++nofCrossings;
+  }
+  timer.Stop();
+  G4double legacyTime = timer.GetRealElapsed();
+  PrintResult("names", nofSteps, legacyTime, sum/std::max(nofCrossings, 1));
+
+  sum = 0.;
+  nofCrossings = 0;
+  timer.Start();
+  for (G4int i = 0; i < nofSteps; ++i) {
+    G4int j = i & (kNofSteps-1);
+    if ( ! filter.IsFluxCrossing(preVolumes[j], postVolumes[j]) ) continue;
+    sum += filter.GetHistoId(stepParticles[j]);
+    ++nofCrossings;
+  }
+  timer.Stop();
+  G4double filterTime = timer.GetRealElapsed();
+  PrintResult("pointers", nofSteps, filterTime, sum/std::max(nofCrossings, 1));
+
+  if ( filterTime > 0. ) {
+    G4cout << "  speed-up: " << legacyTime/filterTime << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void Benchmarks::HitRecording(G4int nofSteps)
+{
+  if ( nofSteps <= 0 ) return;
+
+  auto calorimeter = G4PhysicalVolumeStore::GetInstance()->GetVolume("Calorimeter", false);
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if ( ! calorimeter || ! detector ) {
+    G4cout << "---> Hit recording benchmark needs the geometry, run /run/initialize"
+           << G4endl;
+    return;
+  }
+
+  // steps of muons and electrons at random points of the films, located
+  // in the geometry; tracks of 1-4 steps per film, the first entering it,
+  // as in the events, and 64 steps per "event"
+  const G4int kNofSteps = 1 << 12;
+  const G4int kStepsPerEvent = 64;
+  G4Navigator navigator;
+  navigator.SetWorldVolume(
+    G4TransportationManager::GetTransportationManager()
+      ->GetNavigatorForTracking()->GetWorldVolume());
+  G4ThreeVector min, max;
+  calorimeter->GetLogicalVolume()->GetSolid()->BoundingLimits(min, max);
+  min += calorimeter->GetTranslation();
+  max += calorimeter->GetTranslation();
+
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  const G4ParticleDefinition* particles[2]
+    = { particleTable->FindParticle("mu-"), particleTable->FindParticle("e-") };
+  const G4VProcess* process = nullptr;
+  if ( particles[0]->GetProcessManager() ) {
+    auto processes = particles[0]->GetProcessManager()->GetProcessList();
+    if ( processes->size() > 0 ) process = (*processes)[0];
+  }
+
+  std::vector<G4Step*> steps;
+  G4int trackID = 0, nofTrackSteps = 0;
+  G4int nofAttempts = 0;
+  while ( G4int(steps.size()) < kNofSteps && nofAttempts++ < 1000*kNofSteps ) {
+    G4ThreeVector position(min.x() + G4UniformRand()*(max.x()-min.x()),
+                           min.y() + G4UniformRand()*(max.y()-min.y()),
+                           min.z() + G4UniformRand()*(max.z()-min.z()));
+    auto volume = navigator.LocateGlobalPointAndSetup(position, nullptr, false, true);
+    if ( ! volume || volume->GetLogicalVolume()->GetName() != "EmulsionLV" ) continue;
+
+    G4bool entry = ( nofTrackSteps == 0 );
+    if ( entry ) {
+      ++trackID;
+      nofTrackSteps = 1 + G4int(4*G4UniformRand());
+    }
+    --nofTrackSteps;
+    auto particle = particles[trackID % 2];
+    G4double energy = ( trackID % 2 ) ? 10.*MeV : 100.*GeV;
+    G4double edep = 10.*keV*G4UniformRand();
+    auto track = new G4Track(
+      new G4DynamicParticle(particle, G4ThreeVector(0., 0., 1.), energy), 0., position);
+    track->SetTrackID(trackID);
+    track->SetParentID(trackID % 2);
+    auto step = new G4Step();
+    step->SetTrack(track);
+    step->SetTotalEnergyDeposit(edep);
+    step->SetStepLength(10.*um);
+    auto preStepPoint = step->GetPreStepPoint();
+    preStepPoint->SetPosition(position);
+    preStepPoint->SetMomentumDirection(G4ThreeVector(0., 0., 1.));
+    preStepPoint->SetMass(particle->GetPDGMass());
+    preStepPoint->SetKineticEnergy(energy);
+    preStepPoint->SetStepStatus(entry ? fGeomBoundary : fPostStepDoItProc);
+    preStepPoint->SetTouchableHandle(navigator.CreateTouchableHistory());
+    auto postStepPoint = step->GetPostStepPoint();
+    postStepPoint->SetKineticEnergy(energy - edep);
+    postStepPoint->SetProcessDefinedStep(process);
+    steps.push_back(step);
+  }
+  if ( steps.empty() ) {
+    G4cout << "---> Hit recording benchmark found no emulsion film" << G4endl;
+    return;
+  }
+
+  G4cout << G4endl << "---> Hit recording benchmark, " << nofSteps
+         << " steps in the films, " << steps.size() << " distinct"
+         << " (check value = hits per event)" << G4endl;
+
+  processRegistry.Build();
+  G4Timer timer;
+  G4int nofEvents = 0;
+  G4double nofHits = 0.;
+  std::vector<LegacyHit*> legacyHits;
+  emulsionHits.Clear();
+  timer.Start();
+  for (G4int i = 0; i < nofSteps; ++i) {
+    LegacyProcessHits(steps[i % steps.size()], legacyHits);
+    if ( (i+1) % kStepsPerEvent == 0 || i+1 == nofSteps ) {
+      LegacyEndOfEvent(legacyHits);
+      nofHits += emulsionHits.GetSize();
+      emulsionHits.Clear();
+      ++nofEvents;
+    }
+  }
+  timer.Stop();
+  G4double legacyTime = timer.GetRealElapsed();
+  PrintResult("legacy", nofSteps, legacyTime, nofHits/nofEvents);
+
+  const G4String policyNames[3] = { "entry", "step", "track" };
+  const CalorimeterSD::HitPolicy policies[3]
+    = { DetectorConstruction::kHitEntry, DetectorConstruction::kHitStep,
+        DetectorConstruction::kHitTrack };
+  for (G4int k = 0; k < 3; ++k) {
+    CalorimeterSD sd("BenchmarkSD", detector->GetNofLayers());
+    sd.SetHitPolicy(policies[k]);
+    nofEvents = 0;
+    nofHits = 0.;
+    sd.Initialize(nullptr);
+    timer.Start();
+    for (G4int i = 0; i < nofSteps; ++i) {
+      sd.ProcessHits(steps[i % steps.size()], nullptr);
+      if ( (i+1) % kStepsPerEvent == 0 || i+1 == nofSteps ) {
+        nofHits += emulsionHits.GetSize();
+        emulsionHits.Clear();
+        sd.Initialize(nullptr);
+        ++nofEvents;
+      }
+    }
+    timer.Stop();
+    G4double time = timer.GetRealElapsed();
+    PrintResult(policyNames[k], nofSteps, time, nofHits/nofEvents);
+    if ( time > 0. ) {
+      G4cout << "  " << std::setw(12) << "" << "  steps/s: " << nofSteps/time
+             << ", speed-up: " << legacyTime/time << G4endl;
+    }
+  }
+
+  for (auto step : steps) {
+    delete step->GetTrack();
+    delete step;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,25 +28,21 @@
 /// \brief Implementation of the CalorimeterSD class
 
 #include "CalorimeterSD.hh"
-#include "G4HCofThisEvent.hh"
+#include "Analysis.hh"
+
 #include "G4Step.hh"
-#include "G4VProcess.hh"
-#include "G4ThreeVector.hh"
-#include "G4SDManager.hh"
 #include "G4ios.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorimeterSD::CalorimeterSD(
-			     const G4String& name, 
-			     const G4String& hitsCollectionName,
-			     G4int nofLayers)
+CalorimeterSD::CalorimeterSD(const G4String& name, G4int nofLayers,
+                             const DetectorConstruction* detector)
  : G4VSensitiveDetector(name),
-   fHitsCollection(nullptr),
-   fNofLayers(nofLayers)
-{
-  collectionName.insert(hitsCollectionName);
-}
+   fDetector(detector),
+   fNofLayers(nofLayers),
+   fPolicy(DetectorConstruction::kHitEntry),
+   fTrackHits()
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -56,16 +52,11 @@ CalorimeterSD::~CalorimeterSD()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void CalorimeterSD::Initialize(G4HCofThisEvent* hce)
+void CalorimeterSD::Initialize(G4HCofThisEvent*)
 {
-  // Create hits collection
-  fHitsCollection 
-    = new CalorHitsCollection(SensitiveDetectorName, collectionName[0]); 
-
-  // Add this collection in hce
-  auto hcID 
-    = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  hce->AddHitsCollection( hcID, fHitsCollection );
+  // the policy is switched between runs only
+  if ( fDetector ) fPolicy = fDetector->GetHitPolicy();
+  fTrackHits.Clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -73,14 +64,16 @@ void CalorimeterSD::Initialize(G4HCofThisEvent* hce)
 G4bool CalorimeterSD::ProcessHits(G4Step* step, 
 				  G4TouchableHistory*)
 {  
-  // energy deposit
+  // stage 1: rejection on the step itself
   G4double edep = step->GetTotalEnergyDeposit();
   if ( edep==0. ) return false; 
 
   const G4StepPoint* preStepPoint = step->GetPreStepPoint();
+  if ( fPolicy == DetectorConstruction::kHitEntry
+       && preStepPoint->GetStepStatus() != fGeomBoundary ) return false;
+
+  // stage 2: the film, from the touchable
   auto touchable = preStepPoint->GetTouchable();
-    
-  // Get calorimeter cell id 
   auto replicaNumber = touchable->GetReplicaNumber(1);
   auto copyNumber = touchable->GetCopyNumber();
   
@@ -91,62 +84,47 @@ G4bool CalorimeterSD::ProcessHits(G4Step* step,
       "MyCode0004", FatalException, msg);
   }         
 
-  const G4StepStatus status = preStepPoint->GetStepStatus();
-
-  G4ParticleDefinition*  pd = step->GetTrack()->GetDefinition();
-  G4int particleID   = pd->GetPDGEncoding();
-  G4int trackID      = step->GetTrack()->GetTrackID();
-  G4int parentID     = step->GetTrack()->GetParentID();
-  G4double charge    = pd->GetPDGCharge();
-  G4ThreeVector pos  = preStepPoint->GetPosition();
-  G4ThreeVector mom  = preStepPoint->GetMomentum();
-
-  G4double kE1      = preStepPoint->GetKineticEnergy();
-  G4double kE2      = step->GetPostStepPoint()->GetKineticEnergy();
-  G4double len      = step->GetStepLength();
-  const G4VProcess* proc = step->GetPostStepPoint()->GetProcessDefinedStep();
-  G4String procName = proc ? proc->GetProcessName() : "";
-
-  if (status == fGeomBoundary) {
-    CalorHit* hit = new CalorHit();
-
-    hit->SetChamber(0);
-    hit->SetIDZ(replicaNumber);
-    hit->SetIDZsub(copyNumber);
-    hit->SetParticleID(particleID);
-    hit->SetTrackID(trackID);
-    hit->SetParentID(parentID);
-    hit->SetCharge(charge);
-    hit->SetPosition(pos);
-    hit->SetMomentum(mom);
-    hit->SetEnergyPreS(kE1);
-    hit->SetEnergyPost(kE2);
-    hit->SetEnergyDepo(edep);
-    hit->SetTrackLength(len);
-    hit->SetProcessName(procName);
-
-    fHitsCollection->insert(hit);
+  // stage 3: the hit, a new one or the one of the track in this film
+  if ( fPolicy == DetectorConstruction::kHitTrack ) {
+    G4long key = TrackFilmIndex::GetKey(step->GetTrack()->GetTrackID(),
+                                        replicaNumber, copyNumber);
+    G4bool inserted;
+    std::size_t hit = fTrackHits.FindOrInsert(key, emulsionHits.GetSize(), inserted);
+    if ( ! inserted ) {
+      emulsionHits.Accumulate(hit,
+                              step->GetPostStepPoint()->GetKineticEnergy(),
+                              edep, step->GetStepLength());
+      return true;
+    }
   }
+  Record(step, preStepPoint, replicaNumber, copyNumber);
 
   return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void CalorimeterSD::Record(const G4Step* step, const G4StepPoint* preStepPoint,
+                           G4int layer, G4int film)
+{
+  const G4Track* track = step->GetTrack();
+  const G4ParticleDefinition* pd = track->GetDefinition();
+  const G4StepPoint* postStepPoint = step->GetPostStepPoint();
+  emulsionHits.Add(layer, film,
+                   pd->GetPDGEncoding(), track->GetTrackID(), track->GetParentID(),
+                   pd->GetPDGCharge(),
+                   preStepPoint->GetPosition(), preStepPoint->GetMomentum(),
+                   preStepPoint->GetKineticEnergy(),
+                   postStepPoint->GetKineticEnergy(),
+                   step->GetTotalEnergyDeposit(), step->GetStepLength(),
+                   processRegistry.GetId(postStepPoint->GetProcessDefinedStep()));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void CalorimeterSD::EndOfEvent(G4HCofThisEvent*)
 {
-  if ( verboseLevel>1 ) { 
-     auto nofHits = fHitsCollection->entries();
-     G4cout
-       << G4endl 
-       << "-------->Hits Collection: in this event they are " << nofHits 
-       << " hits in the detector. The hit processes are ";
-     G4int maxN = nofHits>25 ? 25 : nofHits;
-     for(auto i=0; i<maxN; i++) {
-       G4cout << (*fHitsCollection)[i]->GetProcessName() << " ";
-     }
-     G4cout << "..." << G4endl;
-  }
+  if ( verboseLevel>1 ) emulsionHits.Print(25);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,6 +28,11 @@
 /// \brief Implementation of the DetectorConstruction class
 
 #include "DetectorConstruction.hh"
+#include "DetectorMessenger.hh"
+#include "FieldMap.hh"
+#include "OverlapChecker.hh"
+#include "RockTables.hh"
+#include "RockTransportModel.hh"
 #include "CalorimeterSD.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
@@ -35,12 +40,18 @@
 #include "G4Box.hh"
 #include "G4Trap.hh"
 #include "G4LogicalVolume.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
 #include "G4GlobalMagFieldMessenger.hh"
+#include "G4TransportationManager.hh"
+#include "G4FieldManager.hh"
 #include "G4AutoDelete.hh"
 
 #include "G4SDManager.hh"
+#include "G4RunManager.hh"
 
 #include "G4VisAttributes.hh"
 #include "G4Colour.hh"
@@ -48,41 +59,342 @@
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
+#ifdef G4LIB_USE_GDML
+#include "G4GDMLParser.hh"
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  // part of the geometry hash, to be bumped when DefineVolumes() changes
+  const G4int kGeometryVersion = 1;
+
+  // regions and their root logical volumes
+  const char* kRegionNames[3] = { "Rock", "Gap", "Calorimeter" };
+}
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4ThreadLocal 
 G4GlobalMagFieldMessenger* DetectorConstruction::fMagFieldMessenger = 0; 
+G4ThreadLocal
+RockTransportModel* DetectorConstruction::fRockModel = nullptr;
+G4ThreadLocal
+FieldMap* DetectorConstruction::fThreadFieldMap = nullptr;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::DetectorConstruction()
  : G4VUserDetectorConstruction(),
-   fCheckOverlaps(true),
-   fNofLayers(-1)
+   fMessenger(nullptr),
+   fOverlapChecker(nullptr),
+   fBuiltHash(""),
+   fCheckOverlaps(false),
+   fNofLayers(1),
+   fAbsoThickness(1.00*mm),
+   fEmulThickness(0.05*mm),
+   fBaseThickness(0.20*mm),
+   fGdmlCacheDir(""),
+   fPrintMaterials(true),
+   fRockMode(kRockFull),
+   fRockTablesFile("FASERnu_rock.txt"),
+   fRockTables(nullptr),
+   fValidateRock(false),
+   fRangeKill(false),
+   fRangeMargin(1.*cm),
+   fFieldMap(nullptr),
+   fHitPolicy(kHitEntry)
 {
+  fMessenger = new DetectorMessenger(this);
+  fOverlapChecker = new OverlapChecker();
+  fRockTables = new RockTables();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 DetectorConstruction::~DetectorConstruction()
 { 
+  delete fMessenger;
+  delete fOverlapChecker;
+  delete fRockTables;
+  delete fFieldMap;
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void DetectorConstruction::SetNofLayers(G4int nofLayers)
+{
+  fNofLayers = nofLayers;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetAbsorberThickness(G4double thickness)
+{
+  fAbsoThickness = thickness;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetEmulsionThickness(G4double thickness)
+{
+  fEmulThickness = thickness;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetBaseThickness(G4double thickness)
+{
+  fBaseThickness = thickness;
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::RebuildGeometry()
+{
+  // the regions outlive the volume stores, release their root volumes
+  // before these are deleted
+  auto regionStore = G4RegionStore::GetInstance();
+  for (auto name : kRegionNames) {
+    auto region = regionStore->GetRegion(name, false);
+    if ( ! region ) continue;
+    auto it = region->GetRootLogicalVolumeIterator();
+    std::vector<G4LogicalVolume*> roots(it, it+region->GetNumberOfRootVolumes());
+    for (auto volume : roots) region->RemoveRootLogicalVolume(volume);
+  }
+
+  G4RunManager::GetRunManager()->ReinitializeGeometry(true);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetFieldMap(const G4String& fileName)
+{
+  // a map which cannot be read is rejected and the previous one kept;
+  // the threads' copies share the grid, a replaced map can be deleted
+  FieldMap* fieldMap = nullptr;
+  if ( fileName != "none" ) {
+    fieldMap = new FieldMap();
+    if ( ! fieldMap->Read(fileName) ) {
+      delete fieldMap;
+      G4ExceptionDescription msg;
+      msg << "Cannot read the field map " << fileName << ": missing, not a"
+          << " field map or truncated." << G4endl;
+      msg << "The command is ignored, the field is unchanged.";
+      G4Exception("DetectorConstruction::SetFieldMap()",
+        "MyCode0016", JustWarning, msg);
+      return;
+    }
+    G4cout << "---> Field map " << fileName << ": "
+           << fieldMap->GetNofPoints() << " grid points" << G4endl;
+  }
+
+  delete fFieldMap;
+  fFieldMap = fieldMap;
+
+  RebuildGeometry();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetGdmlCache(const G4String& directory)
+{
+  fGdmlCacheDir = ( directory == "none" ) ? "" : directory;
+#ifndef G4LIB_USE_GDML
+  if ( fGdmlCacheDir.size() ) {
+    G4ExceptionDescription msg;
+    msg << "Geant4 is built without GDML, the geometry cache is not used.";
+    G4Exception("DetectorConstruction::SetGdmlCache()",
+      "MyCode0012", JustWarning, msg);
+  }
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String DetectorConstruction::GetGeometryHash() const
+{
+  // FNV-1a of the parameters printed at full precision
+  std::ostringstream parameters;
+  parameters << std::setprecision(17) << kGeometryVersion << ' ' << fNofLayers
+             << ' ' << fAbsoThickness/mm << ' ' << fEmulThickness/mm
+             << ' ' << fBaseThickness/mm;
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : parameters.str()) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream digest;
+  digest << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return digest.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 G4VPhysicalVolume* DetectorConstruction::Construct()
 {
-  // Define materials 
-  DefineMaterials();
+  G4VPhysicalVolume* worldPV = nullptr;
+
+#ifdef G4LIB_USE_GDML
+  // snapshot of the same parameters saved by an earlier job
+  G4String cacheFile;
+  if ( fGdmlCacheDir.size() ) {
+    cacheFile = fGdmlCacheDir + "/FASERnu_" + GetGeometryHash() + ".gdml";
+    worldPV = ReadGdmlCache(cacheFile);
+  }
+#endif
+
+  if ( ! worldPV ) {
+    // Define materials 
+    DefineMaterials();
   
-  // Define volumes
-  return DefineVolumes();
+    // Define volumes
+    worldPV = DefineVolumes();
+
+#ifdef G4LIB_USE_GDML
+    if ( cacheFile.size() ) WriteGdmlCache(cacheFile, worldPV);
+#endif
+  }
+
+  DefineVisAttributes();
+  DefineRegions();
+
+  // validation status of this geometry, the check itself is on demand
+  fBuiltHash = GetGeometryHash();
+  G4int validated = fOverlapChecker->GetCachedResult(fBuiltHash);
+  if ( validated == 0 ) {
+    G4ExceptionDescription msg;
+    msg << "Geometry " << fBuiltHash << " failed its overlap check, see "
+        << fOverlapChecker->GetCacheFile() << ".";
+    G4Exception("DetectorConstruction::Construct()",
+      "MyCode0013", JustWarning, msg);
+  }
+  else {
+    G4cout << "---> Geometry " << fBuiltHash
+           << ( validated == 1 ? " passed its overlap check"
+                               : " not validated, see /FASERnu/det/checkOverlaps" )
+           << G4endl;
+  }
+
+  return worldPV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetOverlapCache(const G4String& fileName)
+{
+  fOverlapChecker->SetCacheFile( fileName == "none" ? G4String("") : fileName );
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool DetectorConstruction::CheckOverlaps(G4int resolution, G4double tolerance,
+                                           G4int nofThreads)
+{
+  // the parameters may have changed since the last construction
+  if ( fBuiltHash.empty() || fBuiltHash != GetGeometryHash() ) {
+    G4ExceptionDescription msg;
+    msg << "The geometry is not built with the current parameters,"
+        << " run /run/initialize first.";
+    G4Exception("DetectorConstruction::CheckOverlaps()",
+      "MyCode0021", JustWarning, msg);
+    return false;
+  }
+  return fOverlapChecker->Check(fBuiltHash, resolution, tolerance, nofThreads);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::SetRockMode(RockMode mode)
+{
+  // the tables are (re)read here, after a calibration run they are current
+  if ( mode == kRockFast && ! fRockTables->Read(fRockTablesFile) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot read the rock tables " << fRockTablesFile
+        << ", the muons are transported with full simulation.";
+    G4Exception("DetectorConstruction::SetRockMode()",
+      "MyCode0014", JustWarning, msg);
+    mode = kRockFull;
+  }
+  fRockMode = mode;
+  if ( mode == kRockFast ) {
+    G4cout << "---> Fast rock transport with " << fRockTablesFile << " ("
+           << fRockTables->GetNofMuons() << " calibrated muons)" << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4VPhysicalVolume* DetectorConstruction::ReadGdmlCache(const G4String& fileName)
+{
+#ifdef G4LIB_USE_GDML
+  if ( ! std::ifstream(fileName).good() ) return nullptr;
+
+  // names were written without pointer suffixes, volumes and materials
+  // are found by name as after a normal construction
+  G4GDMLParser parser;
+  parser.Read(fileName, false);
+  auto worldPV = parser.GetWorldVolume();
+  if ( worldPV ) {
+    G4cout << G4endl << "---> Geometry read from the cache " << fileName
+           << " (" << fNofLayers << " layers)" << G4endl;
+  }
+  return worldPV;
+#else
+  (void)fileName;
+  return nullptr;
+#endif
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::WriteGdmlCache(const G4String& fileName,
+                                          const G4VPhysicalVolume* worldPV) const
+{
+#ifdef G4LIB_USE_GDML
+  // written under a name of this process and renamed, so that concurrent
+  // jobs never read a partial snapshot
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp" << getpid();
+  std::remove(tmpName.str().c_str());
+
+  G4GDMLParser parser;
+  parser.Write(tmpName.str(), worldPV, false);
+  if ( std::rename(tmpName.str().c_str(), fileName.c_str()) != 0 ) {
+    std::remove(tmpName.str().c_str());
+    G4ExceptionDescription msg;
+    msg << "Cannot write the geometry cache " << fileName << ".";
+    G4Exception("DetectorConstruction::WriteGdmlCache()",
+      "MyCode0032", JustWarning, msg);
+    return;
+  }
+  G4cout << "---> Geometry saved to the cache " << fileName << G4endl;
+#else
+  (void)fileName;
+  (void)worldPV;
+#endif
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void DetectorConstruction::DefineMaterials()
 {
+  // defined on the first construction only, a rebuilt geometry reuses them
+  if ( G4Material::GetMaterial("Galactic", false) ) return;
+
   // Tungsten material defined using NIST Manager
   auto nistManager = G4NistManager::Instance();
   nistManager->FindOrBuildMaterial("G4_W"); //Tungsten
@@ -197,7 +509,7 @@ void DetectorConstruction::DefineMaterials()
                   kStateGas, 2.73*kelvin, 3.e-18*pascal);
 
   // Print materials
-  G4cout << *(G4Material::GetMaterialTable()) << G4endl;
+  if ( fPrintMaterials ) G4cout << *(G4Material::GetMaterialTable()) << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -210,10 +522,9 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   G4double rockThickness = 500.*cm;
   G4double rockCaloGap = 315.4*cm;
   
-  fNofLayers = 1; // temporary
-  G4double absoThickness = 1.00*mm;
-  G4double emulThickness = 0.05*mm;
-  G4double baseThickness = 0.20*mm;
+  G4double absoThickness = fAbsoThickness;
+  G4double emulThickness = fEmulThickness;
+  G4double baseThickness = fBaseThickness;
   G4double calorSizeX = 12.5*cm;
   G4double calorSizeY = 10.0*cm;
 
@@ -491,9 +802,46 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
     << emulThickness/mm << "mm of " << emulsionMaterial->GetName() << " ] " << G4endl
     << "------------------------------------------------------------" << G4endl;
   
-  //                                        
-  // Visualization attributes
   //
+  // Always return the physical World
+  //
+  return worldPV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::DefineRegions()
+{
+  // Regions with their own production cuts, set with
+  // /run/setCutForRegion <Rock|Gap|Calorimeter> <cut> <unit>;
+  // without them a region keeps the default cuts.
+  // The calorimeter region covers the whole layer stack.
+  auto regionStore = G4RegionStore::GetInstance();
+  auto volumeStore = G4LogicalVolumeStore::GetInstance();
+  for (auto name : kRegionNames) {
+    auto volume = volumeStore->GetVolume(name);
+    if ( ! volume ) continue;
+    auto region = regionStore->FindOrCreateRegion(name);
+    region->AddRootLogicalVolume(volume);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorConstruction::DefineVisAttributes()
+{
+  // looked up by name, so that a geometry read from the cache gets them too
+  auto store = G4LogicalVolumeStore::GetInstance();
+  auto worldLV = store->GetVolume("World");
+  auto rockLV = store->GetVolume("Rock");
+  auto calorLV = store->GetVolume("Calorimeter");
+  auto layerLV = store->GetVolume("Layer");
+  auto absorberLV = store->GetVolume("AbsoLV");
+  auto baseLV = store->GetVolume("BaseLV");
+  auto emulsionLV = store->GetVolume("EmulsionLV");
+  if ( ! worldLV || ! rockLV || ! calorLV || ! layerLV || ! absorberLV
+       || ! baseLV || ! emulsionLV ) return;
+
   worldLV->SetVisAttributes(G4VisAttributes::GetInvisible());
 
   //auto visAttributes = new G4VisAttributes(G4Colour(1.0,1.0,1.0)); // white
@@ -531,11 +879,6 @@ G4VPhysicalVolume* DetectorConstruction::DefineVolumes()
   // //visAttributes->SetVisibility(false);
   // visAttributes->SetForceSolid(true);
   // gapLV->SetVisAttributes(visAttributes);
-
-  //
-  // Always return the physical World
-  //
-  return worldPV;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -547,23 +890,63 @@ void DetectorConstruction::ConstructSDandField()
   // 
   // Sensitive detectors
   //
+  // kept by the SD manager when the geometry is rebuilt, only the layer
+  // count is updated then
+  auto sdManager = G4SDManager::GetSDMpointer();
   auto emulsionSD 
-    = new CalorimeterSD("EmulsionSD", "EmulsionHitsCollection", fNofLayers);
-  G4SDManager::GetSDMpointer()->AddNewDetector(emulsionSD);
+    = static_cast<CalorimeterSD*>(sdManager->FindSensitiveDetector("EmulsionSD", false));
+  if ( ! emulsionSD ) {
+    emulsionSD = new CalorimeterSD("EmulsionSD", fNofLayers, this);
+    sdManager->AddNewDetector(emulsionSD);
+  }
+  emulsionSD->SetNofLayers(fNofLayers);
   SetSensitiveDetector("EmulsionLV",emulsionSD);
 
+  //
+  // Fast simulation
+  //
+  // the Rock region outlives a rebuilt geometry with its model, which
+  // only acts in the fast rock mode
+  auto rockRegion = G4RegionStore::GetInstance()->GetRegion("Rock", false);
+  if ( rockRegion && ! fRockModel ) {
+    fRockModel = new RockTransportModel("RockTransport", rockRegion, this);
+    G4AutoDelete::Register(fRockModel);
+  }
+
   // 
   // Magnetic field
   //
   // Create global magnetic field messenger.
   // Uniform magnetic field is then created automatically if
   // the field value is not zero.
-  G4ThreeVector fieldValue;
-  fMagFieldMessenger = new G4GlobalMagFieldMessenger(fieldValue);
-  fMagFieldMessenger->SetVerboseLevel(1);
+  if ( ! fMagFieldMessenger ) {
+    G4ThreeVector fieldValue;
+    fMagFieldMessenger = new G4GlobalMagFieldMessenger(fieldValue);
+    fMagFieldMessenger->SetVerboseLevel(1);
   
-  // Register the field messenger for deleting
-  G4AutoDelete::Register(fMagFieldMessenger);
+    // Register the field messenger for deleting
+    G4AutoDelete::Register(fMagFieldMessenger);
+  }
+
+  //
+  // Field map
+  //
+  // installed after the field messenger, which clears the field when
+  // created; each thread installs its own copy, with its own cache of the
+  // last cell; the copies are kept until the end of the thread as the field
+  // manager's chord finder may still refer to them
+  auto fieldManager
+    = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+  if ( fFieldMap ) {
+    fThreadFieldMap = new FieldMap(*fFieldMap);
+    G4AutoDelete::Register(fThreadFieldMap);
+    fieldManager->SetDetectorField(fThreadFieldMap);
+    fieldManager->CreateChordFinder(fThreadFieldMap);
+  }
+  else if ( fThreadFieldMap ) {
+    fieldManager->SetDetectorField(nullptr);
+    fThreadFieldMap = nullptr;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
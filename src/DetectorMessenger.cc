@@ -0,0 +1,297 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file DetectorMessenger.cc
+/// \brief Implementation of the DetectorMessenger class
+
+#include "DetectorMessenger.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorMessenger::DetectorMessenger(DetectorConstruction* detector)
+ : G4UImessenger(),
+   fDetector(detector),
+   fDetDir(nullptr),
+   fNofLayersCmd(nullptr),
+   fAbsoThicknessCmd(nullptr),
+   fEmulThicknessCmd(nullptr),
+   fBaseThicknessCmd(nullptr),
+   fGdmlCacheCmd(nullptr),
+   fPrintMaterialsCmd(nullptr),
+   fCheckOverlapsCmd(nullptr),
+   fOverlapCacheCmd(nullptr),
+   fFieldMapCmd(nullptr),
+   fHitPolicyCmd(nullptr),
+   fRockDir(nullptr),
+   fRockModeCmd(nullptr),
+   fRockTablesCmd(nullptr),
+   fValidateRockCmd(nullptr),
+   fRangeKillCmd(nullptr),
+   fRangeMarginCmd(nullptr)
+{
+  fDetDir = new G4UIdirectory("/FASERnu/det/");
+  fDetDir->SetGuidance("Detector geometry control");
+
+  fNofLayersCmd = new G4UIcmdWithAnInteger("/FASERnu/det/nofLayers", this);
+  fNofLayersCmd->SetGuidance("Set the number of lead/emulsion/base layers.");
+  fNofLayersCmd->SetParameterName("nofLayers", false);
+  fNofLayersCmd->SetRange("nofLayers>0");
+  fNofLayersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fNofLayersCmd->SetToBeBroadcasted(false);
+
+  fAbsoThicknessCmd = new G4UIcmdWithADoubleAndUnit("/FASERnu/det/absorberThickness", this);
+  fAbsoThicknessCmd->SetGuidance("Set the thickness of the lead plate of a layer.");
+  fAbsoThicknessCmd->SetParameterName("thickness", false);
+  fAbsoThicknessCmd->SetRange("thickness>0.");
+  fAbsoThicknessCmd->SetUnitCategory("Length");
+  fAbsoThicknessCmd->SetDefaultUnit("mm");
+  fAbsoThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAbsoThicknessCmd->SetToBeBroadcasted(false);
+
+  fEmulThicknessCmd = new G4UIcmdWithADoubleAndUnit("/FASERnu/det/emulsionThickness", this);
+  fEmulThicknessCmd->SetGuidance("Set the thickness of each of the two emulsion films.");
+  fEmulThicknessCmd->SetParameterName("thickness", false);
+  fEmulThicknessCmd->SetRange("thickness>0.");
+  fEmulThicknessCmd->SetUnitCategory("Length");
+  fEmulThicknessCmd->SetDefaultUnit("mm");
+  fEmulThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fEmulThicknessCmd->SetToBeBroadcasted(false);
+
+  fBaseThicknessCmd = new G4UIcmdWithADoubleAndUnit("/FASERnu/det/baseThickness", this);
+  fBaseThicknessCmd->SetGuidance("Set the thickness of the plastic base between the films.");
+  fBaseThicknessCmd->SetParameterName("thickness", false);
+  fBaseThicknessCmd->SetRange("thickness>0.");
+  fBaseThicknessCmd->SetUnitCategory("Length");
+  fBaseThicknessCmd->SetDefaultUnit("mm");
+  fBaseThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBaseThicknessCmd->SetToBeBroadcasted(false);
+
+  fGdmlCacheCmd = new G4UIcmdWithAString("/FASERnu/det/gdmlCache", this);
+  fGdmlCacheCmd->SetGuidance("Directory of GDML geometry snapshots keyed by the parameter hash:");
+  fGdmlCacheCmd->SetGuidance("read instead of constructing when present, written otherwise.");
+  fGdmlCacheCmd->SetGuidance("none switches the cache off.");
+  fGdmlCacheCmd->SetParameterName("directory", false);
+  fGdmlCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fGdmlCacheCmd->SetToBeBroadcasted(false);
+
+  fPrintMaterialsCmd = new G4UIcmdWithABool("/FASERnu/det/printMaterials", this);
+  fPrintMaterialsCmd->SetGuidance("Print the material table when the materials are defined.");
+  fPrintMaterialsCmd->SetParameterName("print", false);
+  fPrintMaterialsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPrintMaterialsCmd->SetToBeBroadcasted(false);
+
+  fCheckOverlapsCmd = new G4UIcommand("/FASERnu/det/checkOverlaps", this);
+  fCheckOverlapsCmd->SetGuidance("Check all placed volumes of the built geometry for overlaps,");
+  fCheckOverlapsCmd->SetGuidance("in parallel (nofThreads 0 = all cores), and cache the result");
+  fCheckOverlapsCmd->SetGuidance("for the geometry hash. Run /run/initialize after a change first.");
+  auto resolutionParam = new G4UIparameter("resolution", 'i', true);
+  resolutionParam->SetDefaultValue(1000);
+  resolutionParam->SetParameterRange("resolution>0");
+  fCheckOverlapsCmd->SetParameter(resolutionParam);
+  auto toleranceParam = new G4UIparameter("tolerance", 'd', true);
+  toleranceParam->SetDefaultValue(0.);
+  toleranceParam->SetParameterRange("tolerance>=0.");
+  fCheckOverlapsCmd->SetParameter(toleranceParam);
+  auto unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultValue("mm");
+  fCheckOverlapsCmd->SetParameter(unitParam);
+  auto threadsParam = new G4UIparameter("nofThreads", 'i', true);
+  threadsParam->SetDefaultValue(0);
+  threadsParam->SetParameterRange("nofThreads>=0");
+  fCheckOverlapsCmd->SetParameter(threadsParam);
+  fCheckOverlapsCmd->AvailableForStates(G4State_Idle);
+  fCheckOverlapsCmd->SetToBeBroadcasted(false);
+
+  fOverlapCacheCmd = new G4UIcmdWithAString("/FASERnu/det/overlapCache", this);
+  fOverlapCacheCmd->SetGuidance("File of the overlap check results per geometry hash,");
+  fOverlapCacheCmd->SetGuidance("none to keep no record.");
+  fOverlapCacheCmd->SetParameterName("fileName", false);
+  fOverlapCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fOverlapCacheCmd->SetToBeBroadcasted(false);
+
+  fFieldMapCmd = new G4UIcmdWithAString("/FASERnu/det/fieldMap", this);
+  fFieldMapCmd->SetGuidance("Read a binary field map, interpolated in place of the uniform");
+  fFieldMapCmd->SetGuidance("field (see FieldMap.hh for the format); none switches it off.");
+  fFieldMapCmd->SetParameterName("fileName", false);
+  fFieldMapCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fFieldMapCmd->SetToBeBroadcasted(false);
+
+  fHitPolicyCmd = new G4UIcmdWithAString("/FASERnu/det/hitPolicy", this);
+  fHitPolicyCmd->SetGuidance("Select the steps recorded in the emulsion films:");
+  fHitPolicyCmd->SetGuidance("  entry : the steps entering a film;");
+  fHitPolicyCmd->SetGuidance("  step  : every step with an energy deposit;");
+  fHitPolicyCmd->SetGuidance("  track : one hit per track and film, from its first step,");
+  fHitPolicyCmd->SetGuidance("          with the energy deposits and lengths summed.");
+  fHitPolicyCmd->SetParameterName("policy", false);
+  fHitPolicyCmd->SetCandidates("entry step track");
+  fHitPolicyCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fHitPolicyCmd->SetToBeBroadcasted(false);
+
+  fRockDir = new G4UIdirectory("/FASERnu/rock/");
+  fRockDir->SetGuidance("Muon transport through the rock");
+
+  fRockModeCmd = new G4UIcmdWithAString("/FASERnu/rock/mode", this);
+  fRockModeCmd->SetGuidance("Select the muon transport through the rock:");
+  fRockModeCmd->SetGuidance("  full      : full simulation;");
+  fRockModeCmd->SetGuidance("  calibrate : full simulation, the rock tables are filled");
+  fRockModeCmd->SetGuidance("              and written at the end of run;");
+  fRockModeCmd->SetGuidance("  fast      : the tables are read and the muons moved to");
+  fRockModeCmd->SetGuidance("              the rock exit by the fast simulation model.");
+  fRockModeCmd->SetParameterName("mode", false);
+  fRockModeCmd->SetCandidates("full calibrate fast");
+  fRockModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRockModeCmd->SetToBeBroadcasted(false);
+
+  fRockTablesCmd = new G4UIcmdWithAString("/FASERnu/rock/tables", this);
+  fRockTablesCmd->SetGuidance("File of the rock tables, written by the calibrate mode");
+  fRockTablesCmd->SetGuidance("and read by the fast mode.");
+  fRockTablesCmd->SetParameterName("fileName", false);
+  fRockTablesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRockTablesCmd->SetToBeBroadcasted(false);
+
+  fValidateRockCmd = new G4UIcmdWithABool("/FASERnu/rock/validate", this);
+  fValidateRockCmd->SetGuidance("Keep the flux spectra of the full and calibrate runs and");
+  fValidateRockCmd->SetGuidance("compare those of the fast runs with them.");
+  fValidateRockCmd->SetParameterName("validate", false);
+  fValidateRockCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fValidateRockCmd->SetToBeBroadcasted(false);
+
+  fRangeKillCmd = new G4UIcmdWithABool("/FASERnu/rock/rangeKill", this);
+  fRangeKillCmd->SetGuidance("Kill the charged secondaries born in the rock whose range");
+  fRangeKillCmd->SetGuidance("plus the margin is shorter than their distance to its surface.");
+  fRangeKillCmd->SetGuidance("Off by default, it is not validated for the gamma and e+- flux.");
+  fRangeKillCmd->SetParameterName("rangeKill", false);
+  fRangeKillCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRangeKillCmd->SetToBeBroadcasted(false);
+
+  fRangeMarginCmd = new G4UIcmdWithADoubleAndUnit("/FASERnu/rock/rangeMargin", this);
+  fRangeMarginCmd->SetGuidance("Set the safety margin added to the range of a secondary.");
+  fRangeMarginCmd->SetParameterName("margin", false);
+  fRangeMarginCmd->SetRange("margin>=0.");
+  fRangeMarginCmd->SetUnitCategory("Length");
+  fRangeMarginCmd->SetDefaultUnit("cm");
+  fRangeMarginCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRangeMarginCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+DetectorMessenger::~DetectorMessenger()
+{
+  delete fNofLayersCmd;
+  delete fAbsoThicknessCmd;
+  delete fEmulThicknessCmd;
+  delete fBaseThicknessCmd;
+  delete fGdmlCacheCmd;
+  delete fPrintMaterialsCmd;
+  delete fCheckOverlapsCmd;
+  delete fOverlapCacheCmd;
+  delete fFieldMapCmd;
+  delete fHitPolicyCmd;
+  delete fDetDir;
+  delete fRockModeCmd;
+  delete fRockTablesCmd;
+  delete fValidateRockCmd;
+  delete fRangeKillCmd;
+  delete fRangeMarginCmd;
+  delete fRockDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void DetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fNofLayersCmd ) {
+    fDetector->SetNofLayers(fNofLayersCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fAbsoThicknessCmd ) {
+    fDetector->SetAbsorberThickness(fAbsoThicknessCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fEmulThicknessCmd ) {
+    fDetector->SetEmulsionThickness(fEmulThicknessCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fBaseThicknessCmd ) {
+    fDetector->SetBaseThickness(fBaseThicknessCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fGdmlCacheCmd ) {
+    fDetector->SetGdmlCache(newValue);
+  }
+  else if ( command == fPrintMaterialsCmd ) {
+    fDetector->SetPrintMaterials(fPrintMaterialsCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fCheckOverlapsCmd ) {
+    std::istringstream is(newValue);
+    G4int resolution, nofThreads;
+    G4double tolerance;
+    G4String unit;
+    is >> resolution >> tolerance >> unit >> nofThreads;
+    tolerance *= G4UIcommand::ValueOf(unit);
+    fDetector->CheckOverlaps(resolution, tolerance, nofThreads);
+  }
+  else if ( command == fOverlapCacheCmd ) {
+    fDetector->SetOverlapCache(newValue);
+  }
+  else if ( command == fFieldMapCmd ) {
+    fDetector->SetFieldMap(newValue);
+  }
+  else if ( command == fHitPolicyCmd ) {
+    auto policy = ( newValue == "step" ) ? DetectorConstruction::kHitStep
+                : ( newValue == "track" ) ? DetectorConstruction::kHitTrack
+                : DetectorConstruction::kHitEntry;
+    fDetector->SetHitPolicy(policy);
+  }
+  else if ( command == fRockModeCmd ) {
+    auto mode = ( newValue == "fast" ) ? DetectorConstruction::kRockFast
+              : ( newValue == "calibrate" ) ? DetectorConstruction::kRockCalibrate
+              : DetectorConstruction::kRockFull;
+    fDetector->SetRockMode(mode);
+  }
+  else if ( command == fRockTablesCmd ) {
+    fDetector->SetRockTablesFile(newValue);
+  }
+  else if ( command == fValidateRockCmd ) {
+    fDetector->SetValidateRock(fValidateRockCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fRangeKillCmd ) {
+    fDetector->SetRangeKill(fRangeKillCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fRangeMarginCmd ) {
+    fDetector->SetRangeMargin(fRangeMarginCmd->GetNewDoubleValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,122 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EmulsionHits.cc
+/// \brief Implementation of the EmulsionHits class
+
+#include "EmulsionHits.hh"
+
+#include "G4ios.hh"
+
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmulsionHits::EmulsionHits()
+ : fNofSteps(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EmulsionHits::~EmulsionHits()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmulsionHits::Clear()
+{
+  fNofSteps = 0;
+  cham.clear();
+  idz.clear();
+  idzsub.clear();
+  pdgid.clear();
+  id.clear();
+  idParent.clear();
+  charge.clear();
+  x.clear();
+  y.clear();
+  z.clear();
+  px.clear();
+  py.clear();
+  pz.clear();
+  e1.clear();
+  e2.clear();
+  len.clear();
+  edep.clear();
+  proc.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmulsionHits::Reserve(std::size_t nofHits)
+{
+  cham.reserve(nofHits);
+  idz.reserve(nofHits);
+  idzsub.reserve(nofHits);
+  pdgid.reserve(nofHits);
+  id.reserve(nofHits);
+  idParent.reserve(nofHits);
+  charge.reserve(nofHits);
+  x.reserve(nofHits);
+  y.reserve(nofHits);
+  z.reserve(nofHits);
+  px.reserve(nofHits);
+  py.reserve(nofHits);
+  pz.reserve(nofHits);
+  e1.reserve(nofHits);
+  e2.reserve(nofHits);
+  len.reserve(nofHits);
+  edep.reserve(nofHits);
+  proc.reserve(nofHits);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EmulsionHits::Print(std::size_t maxHits) const
+{
+  std::size_t nofHits = GetSize();
+  G4cout
+    << G4endl
+    << "-------->Emulsion hits: in this event they are " << nofHits
+    << " hits in the detector." << G4endl;
+  for (std::size_t i = 0; i < nofHits && i < maxHits; ++i) {
+    G4cout
+      << "PDGID: "
+      << std::setw(5) << pdgid[i] << " "
+      << "IDZ,IDZsub,X,Y: "
+      << std::setw(3) << idz[i] << " "
+      << std::setw(1) << idzsub[i] << " "
+      << std::setw(6) << x[i] << " "
+      << std::setw(6) << y[i]
+      << ", Edep: "
+      << std::setw(7) << edep[i] << " MeV"
+      << ", process: " << proc[i]
+      << G4endl;
+  }
+  if ( nofHits > maxHits ) G4cout << "..." << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -28,14 +28,12 @@
 /// \brief Implementation of the EventAction class
 
 #include "EventAction.hh"
-#include "CalorimeterSD.hh"
-#include "CalorHit.hh"
 #include "Analysis.hh"
+#include "SourceManager.hh"
+#include "RunAction.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
-#include "G4SDManager.hh"
-#include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
@@ -44,10 +42,15 @@
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EventAction::EventAction()
+EventAction::EventAction(RunAction* runAction, const SourceManager* sourceManager)
  : G4UserEventAction(),
-   fCalorHCID(-1)
-{}
+   fRunAction(runAction),
+   fSourceManager(sourceManager),
+   fPhaseSpaceOutput(nullptr)
+{
+  // built in the worker thread, the capacity is kept from event to event
+  emulsionHits.Reserve(kInitialHits);
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -56,23 +59,6 @@ EventAction::~EventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorHitsCollection* 
-EventAction::GetCalorHitsCollection(G4int hcID, const G4Event* event) const
-{
-  auto hitsCollection =
-    static_cast<CalorHitsCollection*>(event->GetHCofThisEvent()->GetHC(hcID));
-  
-  if ( ! hitsCollection ) {
-    G4ExceptionDescription msg;
-    msg << "Cannot access hitsCollection ID " << hcID; 
-    G4Exception("EventAction::GetCalorHitsCollection()",
-      "MyCode0003", FatalException, msg);
-  }
-  return hitsCollection;
-}
-
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-
 void EventAction::PrintEventStatistics(G4double Edep) const
 {
   // print event statistics
@@ -86,65 +72,29 @@ void EventAction::PrintEventStatistics(G4double Edep) const
 
 void EventAction::BeginOfEventAction(const G4Event* /*event*/)
 {
-  auto sdManager = G4SDManager::GetSDMpointer();
-
-  // Get hit collections IDs (just once)
-  fCalorHCID   = sdManager->GetCollectionID("EmulsionHitsCollection");
+  // recording is switched between runs only
+  fPhaseSpaceOutput = fSourceManager ? fSourceManager->GetPhaseSpaceOutput() : nullptr;
+  fCrossings.clear();
 
   pdg_primary = 0;
   e_primary = x_primary = y_primary = 0;
   pdg_neutron = 0;
   e_neutron = x_neutron = y_neutron = 0;
   
-  cham.clear();
-  idz.clear();
-  idzsub.clear();
-  pdgid.clear();
-  id.clear();
-  idParent.clear();
-  charge.clear();
-  x.clear();
-  y.clear();
-  z.clear();
-  px.clear();
-  py.clear();
-  pz.clear();
-  e1.clear();
-  e2.clear();
-  len.clear();
-  edep.clear();
+  // hits of the event written by CalorimeterSD, no reallocation once
+  // the largest event has been seen
+  emulsionHits.Clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EventAction::EndOfEventAction(const G4Event* event)
+void EventAction::EndOfEventAction(const G4Event* /*event*/)
 {
-  // Get hits collections
-  auto calorHC = GetCalorHitsCollection(fCalorHCID, event);
-
-  for (unsigned long i = 0; i < calorHC->GetSize(); ++i) {
-    auto hit = static_cast<CalorHit*>(calorHC->GetHit(i));
-    //if(hit && hit->GetEnergyDepo()>1*keV) {
-    if(hit) {
-      cham.push_back(hit->GetChamber());
-      idz.push_back(hit->GetIDZ());
-      idzsub.push_back(hit->GetIDZsub());
-      pdgid.push_back(hit->GetParticleID());
-      id.push_back(hit->GetTrackID());
-      idParent.push_back(hit->GetParentID());
-      charge.push_back(hit->GetCharge());
-      x.push_back(hit->GetPosition().x()/mm);
-      y.push_back(hit->GetPosition().y()/mm);
-      z.push_back(hit->GetPosition().z()/mm);
-      px.push_back(hit->GetMomentum().x()/MeV);
-      py.push_back(hit->GetMomentum().y()/MeV);
-      pz.push_back(hit->GetMomentum().z()/MeV);
-      e1.push_back(hit->GetEnergyPreS()/MeV);
-      e2.push_back(hit->GetEnergyPost()/MeV);
-      len.push_back(hit->GetTrackLength()/mm);
-      edep.push_back(hit->GetEnergyDepo()/MeV);
-    }
-  }
+  // stage-1 crossings of this event, written together
+  if ( fPhaseSpaceOutput ) fPhaseSpaceOutput->Write(fCrossings);
+
+  // the emulsion hits are already in the ntuple columns
+  fRunAction->CountHits(emulsionHits.GetSize(), emulsionHits.GetNofSteps());
 
   // // Fill histograms, ntuple
 
@@ -165,6 +115,7 @@ void EventAction::EndOfEventAction(const G4Event* event)
   //   analysisManager->FillNtupleDColumn(9, e_neutron*1000); // MeV
   //   analysisManager->FillNtupleDColumn(10, x_neutron*10); // mm
   //   analysisManager->FillNtupleDColumn(11, y_neutron*10); // mm
+  //   analysisManager->FillNtupleDColumn(12, w_beam);
 
   //   //analysisManager->FillNtupleIColumn(4, pdgnu_nuEvt);
   //   //analysisManager->FillNtupleIColumn(5, pdglep_nuEvt);
@@ -0,0 +1,98 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EventSeeder.cc
+/// \brief Implementation of the EventSeeder class
+
+#include "EventSeeder.hh"
+#include "Philox.hh"
+
+#include "G4GenericMessenger.hh"
+#include "Randomize.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSeeder::EventSeeder()
+ : fMessenger(nullptr),
+   fEnabled(false),
+   fRunSeed(1),
+   fEventOffset(0)
+{
+  fMessenger = new G4GenericMessenger(this, "/FASERnu/random/",
+                                      "Per-event random seeding");
+
+  auto& enableCmd = fMessenger->DeclareProperty("perEventSeeds", fEnabled,
+    "Derive the seeds of each event from (runSeed, run ID, event ID).");
+  enableCmd.SetParameterName("flag", true);
+  enableCmd.SetDefaultValue("true");
+  enableCmd.SetStates(G4State_PreInit, G4State_Idle);
+  enableCmd.SetToBeBroadcasted(false);
+
+  auto& seedCmd = fMessenger->DeclareProperty("runSeed", fRunSeed,
+    "Seed shared by all events of the job when perEventSeeds is on.");
+  seedCmd.SetParameterName("seed", false);
+  seedCmd.SetStates(G4State_PreInit, G4State_Idle);
+  seedCmd.SetToBeBroadcasted(false);
+
+  auto& offsetCmd = fMessenger->DeclareProperty("eventOffset", fEventOffset,
+    "Number added to the event ID; set it to N and shoot 1 event to rerun event N.");
+  offsetCmd.SetParameterName("offset", false);
+  offsetCmd.SetRange("offset>=0");
+  offsetCmd.SetStates(G4State_PreInit, G4State_Idle);
+  offsetCmd.SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EventSeeder::~EventSeeder()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EventSeeder::SeedEvent(G4int runID, G4int eventID) const
+{
+  if ( ! fEnabled ) return;
+
+  const std::uint32_t key[2]
+    = { static_cast<std::uint32_t>(fRunSeed), 0x46415345 }; // "FASE"
+  const std::uint32_t counter[4]
+    = { static_cast<std::uint32_t>(eventID + fEventOffset),
+        static_cast<std::uint32_t>(runID), 0, 0 };
+  std::uint32_t words[4];
+  Philox4x32::Generate(counter, key, words);
+
+  // Two seeds in the valid ranges of RanecuEngine, which they fully
+  // determine; other engines hash them into their own state.
+  long seeds[3];
+  seeds[0] = 1 + static_cast<long>(words[0] % 2147483562u);
+  seeds[1] = 1 + static_cast<long>(words[1] % 2147483398u);
+  seeds[2] = 0;
+  G4Random::setTheSeeds(seeds);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,224 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file FieldMap.cc
+/// \brief Implementation of the FieldMap class
+
+#include "FieldMap.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  struct FieldMapHeader
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint32_t nofPoints[3];
+    std::uint32_t padding;
+    double        min[3];   // mm
+    double        max[3];
+  };
+
+  const char kMagic[8] = { 'F','N','U','F','I','E','L','D' };
+  const std::uint32_t kVersion = 1;
+
+  static_assert(sizeof(FieldMapHeader) == 80, "header must be 80 bytes");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FieldMap::FieldMap()
+ : G4MagneticField(),
+   fGrid(),
+   fFileName(""),
+   fCell(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FieldMap::FieldMap(const FieldMap& other)
+ : G4MagneticField(other),
+   fGrid(other.fGrid),
+   fFileName(other.fFileName),
+   fCell(-1)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+FieldMap::~FieldMap()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Field* FieldMap::Clone() const
+{
+  return new FieldMap(*this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int FieldMap::GetNofPoints() const
+{
+  return fGrid ? fGrid->values.size()/3 : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool FieldMap::SetGrid(const G4int nofPoints[3], const G4double min[3],
+                         const G4double max[3], const std::vector<float>& values)
+{
+  auto grid = std::make_shared<Grid>();
+  std::size_t size = 3;
+  for (G4int axis = 0; axis < 3; ++axis) {
+    if ( nofPoints[axis] < 2 || ! ( max[axis] > min[axis] ) ) return false;
+    grid->nofPoints[axis] = nofPoints[axis];
+    grid->min[axis] = min[axis];
+    grid->max[axis] = max[axis];
+    grid->inverseStep[axis] = (nofPoints[axis]-1)/(max[axis]-min[axis]);
+    size *= nofPoints[axis];
+  }
+  if ( values.size() != size ) return false;
+  grid->values = values;
+
+  fGrid = grid;
+  fCell = -1;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool FieldMap::Read(const G4String& fileName)
+{
+  std::ifstream input(fileName, std::ios::binary);
+  if ( ! input.is_open() ) return false;
+
+  FieldMapHeader header;
+  if ( ! input.read(reinterpret_cast<char*>(&header), sizeof(header))
+       || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0
+       || header.version != kVersion ) return false;
+
+  G4int nofPoints[3];
+  G4double min[3], max[3];
+  std::size_t size = 3;
+  for (G4int axis = 0; axis < 3; ++axis) {
+    if ( header.nofPoints[axis] < 2 || header.nofPoints[axis] > 100000 ) return false;
+    nofPoints[axis] = header.nofPoints[axis];
+    min[axis] = header.min[axis]*mm;
+    max[axis] = header.max[axis]*mm;
+    size *= nofPoints[axis];
+  }
+
+  // the grid must fill the rest of the file, checked before allocating it
+  std::streamoff start = input.tellg();
+  input.seekg(0, std::ios::end);
+  std::streamoff remaining = input.tellg() - start;
+  input.seekg(start);
+  if ( remaining < 0
+       || std::uint64_t(remaining) != std::uint64_t(size)*sizeof(float) ) return false;
+
+  std::vector<float> values(size);
+  if ( ! input.read(reinterpret_cast<char*>(values.data()), size*sizeof(float)) ) return false;
+  if ( ! SetGrid(nofPoints, min, max, values) ) return false;
+  fFileName = fileName;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool FieldMap::Write(const G4String& fileName) const
+{
+  if ( ! fGrid ) return false;
+  std::ofstream output(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! output.is_open() ) return false;
+
+  FieldMapHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  for (G4int axis = 0; axis < 3; ++axis) {
+    header.nofPoints[axis] = fGrid->nofPoints[axis];
+    header.min[axis] = fGrid->min[axis]/mm;
+    header.max[axis] = fGrid->max[axis]/mm;
+  }
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(fGrid->values.data()),
+               fGrid->values.size()*sizeof(float));
+  return output.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void FieldMap::GetFieldValue(const G4double point[4], G4double* field) const
+{
+  field[0] = field[1] = field[2] = 0.;
+  if ( ! fGrid ) return;
+  const Grid& grid = *fGrid;
+
+  // cell and position inside it
+  G4int index[3];
+  G4double u[3];
+  for (G4int axis = 0; axis < 3; ++axis) {
+    G4double t = (point[axis]-grid.min[axis])*grid.inverseStep[axis];
+    if ( ! ( t >= 0. ) || t > grid.nofPoints[axis]-1 ) return;
+    index[axis] = std::min(static_cast<G4int>(t), grid.nofPoints[axis]-2);
+    u[axis] = t - index[axis];
+  }
+
+  G4long nx = grid.nofPoints[0];
+  G4long nxy = nx*grid.nofPoints[1];
+  G4long cell = index[2]*nxy + index[1]*nx + index[0];
+  if ( cell != fCell ) {
+    for (G4int corner = 0; corner < 8; ++corner) {
+      G4long offset = 3*( cell + (corner & 1) + ((corner >> 1) & 1)*nx
+                               + ((corner >> 2) & 1)*nxy );
+      for (G4int c = 0; c < 3; ++c) {
+        fCorners[corner][c] = grid.values[offset+c]*tesla;
+      }
+    }
+    fCell = cell;
+  }
+
+  // along x, then y, then z
+  for (G4int c = 0; c < 3; ++c) {
+    G4double c00 = fCorners[0][c] + u[0]*(fCorners[1][c]-fCorners[0][c]);
+    G4double c10 = fCorners[2][c] + u[0]*(fCorners[3][c]-fCorners[2][c]);
+    G4double c01 = fCorners[4][c] + u[0]*(fCorners[5][c]-fCorners[4][c]);
+    G4double c11 = fCorners[6][c] + u[0]*(fCorners[7][c]-fCorners[6][c]);
+    G4double c0 = c00 + u[1]*(c10-c00);
+    G4double c1 = c01 + u[1]*(c11-c01);
+    field[c] = c0 + u[2]*(c1-c0);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
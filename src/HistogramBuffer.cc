@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistogramBuffer.cc
+/// \brief Implementation of the HistogramBuffer class
+
+#include "HistogramBuffer.hh"
+#include "Analysis.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistogramBuffer::HistogramBuffer()
+ : fHistograms()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistogramBuffer::~HistogramBuffer()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistogramBuffer::Attach()
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  G4int firstId = analysisManager->GetFirstH1Id();
+  G4int lastId = firstId + analysisManager->GetNofH1s() - 1;
+
+  fHistograms.assign(std::max(lastId+1, 0), Histogram());
+  for (G4int id = firstId; id <= lastId; ++id) {
+    auto h1 = analysisManager->GetH1(id, false);
+    Histogram& histogram = fHistograms[id];
+    histogram.filled = false;
+    histogram.nofBins = 0;
+    // variable bins are not buffered, Fill() ignores them
+    if ( ! h1 || ! h1->axis().is_fixed_binning() ) continue;
+    histogram.nofBins = h1->axis().bins();
+    histogram.min = h1->axis().lower_edge();
+    histogram.width = (h1->axis().upper_edge() - histogram.min)/histogram.nofBins;
+    histogram.bins.assign(histogram.nofBins+2, Bin());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistogramBuffer::Flush()
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  for (std::size_t id = 0; id < fHistograms.size(); ++id) {
+    Histogram& histogram = fHistograms[id];
+    if ( ! histogram.filled ) continue;
+    auto h1 = analysisManager->GetH1(id, false);
+    for (std::size_t bin = 0; bin < histogram.bins.size(); ++bin) {
+      Bin& content = histogram.bins[bin];
+      if ( content.entries == 0 ) continue;
+      if ( h1 ) {
+        std::size_t entries;
+        G4double sumW, sumW2, sumXW, sumX2W;
+        h1->get_bin_content(bin, entries, sumW, sumW2, sumXW, sumX2W);
+        h1->set_bin_content(bin, entries + content.entries,
+                            sumW + content.sumW, sumW2 + content.sumW2,
+                            sumXW + content.sumXW, sumX2W + content.sumX2W);
+      }
+      content = Bin();
+    }
+    histogram.filled = false;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
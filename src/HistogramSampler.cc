@@ -0,0 +1,144 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file HistogramSampler.cc
+/// \brief Implementation of the HistogramSampler class
+
+#include "HistogramSampler.hh"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistogramSampler::HistogramSampler(const std::vector<G4double>& binEdges,
+                                   const std::vector<G4double>& binWeights,
+                                   Interpolation interpolation)
+ : fInterpolation(interpolation),
+   fEdges(binEdges),
+   fProb(binWeights),
+   fIntegral(0.)
+{
+  G4bool valid = ( binWeights.size() > 0 ) && ( binEdges.size() == binWeights.size()+1 );
+  for (std::size_t i = 0; valid && i < binWeights.size(); ++i) {
+    if ( binWeights[i] < 0. || ! ( binEdges[i+1] > binEdges[i] ) ) valid = false;
+    else fIntegral += binWeights[i];
+  }
+  if ( ! valid || fIntegral <= 0. ) {
+    G4ExceptionDescription msg;
+    msg << "Invalid histogram: " << binWeights.size() << " weights and "
+        << binEdges.size() << " edges." << G4endl
+        << "Edges must be increasing, weights non-negative with a positive sum.";
+    G4Exception("HistogramSampler::HistogramSampler()",
+      "MyCode0005", FatalException, msg);
+    return;
+  }
+
+  for (auto& prob : fProb) prob /= fIntegral;
+
+  BuildAliasTable();
+  if ( fInterpolation == kLinear ) BuildEdgeDensities();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+HistogramSampler::~HistogramSampler()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistogramSampler::BuildAliasTable()
+{
+  // Vose's variant of Walker's alias method: every column of height 1/n is
+  // filled by its own bin up to fAliasCut and by fAlias above it.
+  G4int nofBins = fProb.size();
+  fAliasCut.assign(nofBins, 1.);
+  fAlias.resize(nofBins);
+
+  std::vector<G4double> scaled(nofBins);
+  std::vector<G4int> small, large;
+  small.reserve(nofBins);
+  large.reserve(nofBins);
+  for (G4int i = 0; i < nofBins; ++i) {
+    fAlias[i] = i;
+    scaled[i] = fProb[i]*nofBins;
+    if ( scaled[i] < 1. ) small.push_back(i);
+    else                  large.push_back(i);
+  }
+
+  while ( ! small.empty() && ! large.empty() ) {
+    G4int s = small.back(); small.pop_back();
+    G4int l = large.back(); large.pop_back();
+    fAliasCut[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] = (scaled[l]+scaled[s])-1.;
+    if ( scaled[l] < 1. ) small.push_back(l);
+    else                  large.push_back(l);
+  }
+
+  // leftovers are only off from 1 by rounding
+  for (auto i : small) fAliasCut[i] = 1.;
+  for (auto i : large) fAliasCut[i] = 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HistogramSampler::BuildEdgeDensities()
+{
+  // Density at each edge is the mean of the two adjacent bin densities,
+  // the outer edges take the density of their own bin.
+  G4int nofBins = fProb.size();
+  std::vector<G4double> density(nofBins);
+  for (G4int i = 0; i < nofBins; ++i) {
+    density[i] = fProb[i]/(fEdges[i+1]-fEdges[i]);
+  }
+
+  fEdgeDensity.resize(nofBins+1);
+  fEdgeDensity[0] = density[0];
+  fEdgeDensity[nofBins] = density[nofBins-1];
+  for (G4int i = 1; i < nofBins; ++i) {
+    fEdgeDensity[i] = 0.5*(density[i-1]+density[i]);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double HistogramSampler::SampleInBin(G4int bin, G4double u2) const
+{
+  G4double low = fEdges[bin];
+  G4double width = fEdges[bin+1]-low;
+  if ( fInterpolation == kUniform ) return low + u2*width;
+
+  // invert the cdf of the linear density f0 + (f1-f0)*t on t in [0,1]
+  G4double f0 = fEdgeDensity[bin];
+  G4double f1 = fEdgeDensity[bin+1];
+  G4double t = u2;
+  if ( std::fabs(f1-f0) > 1.e-9*(f0+f1) ) {
+    t = (std::sqrt(f0*f0 + u2*(f1*f1-f0*f0)) - f0)/(f1-f0);
+  }
+  return low + t*width;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,388 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file NuEventFile.cc
+/// \brief Implementation of the neutrino event file classes
+
+#include "NuEventFile.hh"
+
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  struct NuEventFileHeader
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+  };
+
+  struct NuEventRecord
+  {
+    std::int32_t number, pdgNu, pdgLep, cc, nofParticles;
+    float        eNu, pLep, x, y, z, weight;
+  };
+
+  struct NuParticleRecord
+  {
+    std::int32_t pdg;
+    float        px, py, pz;
+  };
+
+  const char kMagic[8] = { 'F','N','U','E','V','T','\0','\0' };
+  const std::uint32_t kVersion = 1;
+
+  static_assert(sizeof(NuEventFileHeader) == 16, "header must be 16 bytes");
+  static_assert(sizeof(NuEventRecord) == 44, "NuEventRecord must be 44 bytes");
+  static_assert(sizeof(NuParticleRecord) == 16, "NuParticleRecord must be 16 bytes");
+
+  // charged current when the lepton of the neutrino flavour comes out
+  void SetInteraction(NuEvent& event)
+  {
+    event.pdgLep = 0;
+    event.pLep = 0.;
+    event.cc = 0;
+    const NuParticle* lepton = nullptr;
+    for (const auto& particle : event.particles) {
+      if ( std::abs(particle.pdg) == std::abs(event.pdgNu)-1 ) {
+        lepton = &particle;
+        event.cc = 1;
+        break;
+      }
+      if ( ! lepton && particle.pdg == event.pdgNu ) lepton = &particle;
+    }
+    if ( lepton ) {
+      event.pdgLep = lepton->pdg;
+      event.pLep = std::sqrt(lepton->px*lepton->px + lepton->py*lepton->py
+                             + lepton->pz*lepton->pz);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NuEventWriter::NuEventWriter()
+ : fNofEvents(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NuEventWriter::~NuEventWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NuEventWriter::Open(const G4String& fileName)
+{
+  Close();
+  fOutput.open(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! fOutput.is_open() ) return false;
+
+  NuEventFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  fOutput.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fNofEvents = 0;
+  return fOutput.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NuEventWriter::Write(const NuEvent& event)
+{
+  NuEventRecord record;
+  record.number = event.number;
+  record.pdgNu = event.pdgNu;
+  record.pdgLep = event.pdgLep;
+  record.cc = event.cc;
+  record.nofParticles = event.particles.size();
+  record.eNu = event.eNu;
+  record.pLep = event.pLep;
+  record.x = event.x;
+  record.y = event.y;
+  record.z = event.z;
+  record.weight = event.weight;
+  fOutput.write(reinterpret_cast<const char*>(&record), sizeof(record));
+
+  for (const auto& particle : event.particles) {
+    NuParticleRecord particleRecord = { particle.pdg,
+      float(particle.px), float(particle.py), float(particle.pz) };
+    fOutput.write(reinterpret_cast<const char*>(&particleRecord),
+                  sizeof(particleRecord));
+  }
+  ++fNofEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NuEventWriter::Close()
+{
+  if ( fOutput.is_open() ) fOutput.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NuEventReader::NuEventReader(std::size_t capacity)
+ : fFileName(""),
+   fBinary(false),
+   fEnergyUnit(1.),
+   fLengthUnit(0.1),
+   fCapacity(capacity > 0 ? capacity : 1),
+   fEndOfFile(true),
+   fStop(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+NuEventReader::~NuEventReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NuEventReader::Open(const G4String& fileName)
+{
+  Close();
+
+  fInput.open(fileName, std::ios::binary);
+  if ( ! fInput.is_open() ) return false;
+  fFileName = fileName;
+
+  // binary files start with the magic, anything else is parsed as HepMC
+  NuEventFileHeader header;
+  std::memset(&header, 0, sizeof(header));
+  fInput.read(reinterpret_cast<char*>(&header), sizeof(header));
+  fBinary = fInput.gcount() == sizeof(header)
+            && std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0;
+  if ( fBinary && header.version != kVersion ) {
+    Close();
+    return false;
+  }
+  if ( ! fBinary ) {
+    // HepMC3 ASCII has other records (Asciiv3 listing, no barcodes in V/P),
+    // reject it from its header rather than misparsing it as HepMC2
+    fInput.clear();
+    fInput.seekg(0);
+    std::string line;
+    while ( std::getline(fInput, line) && ( line.empty() || line[0] != 'E' ) ) {
+      if ( line.compare(0, 16, "HepMC::Version 3") == 0
+           || line.find("Asciiv3") != std::string::npos ) {
+        Close();
+        return false;
+      }
+    }
+    fInput.clear();
+    fInput.seekg(0);
+  }
+
+  // HepMC default units, GeV and mm
+  fPendingLine.clear();
+  fEnergyUnit = 1.;
+  fLengthUnit = 0.1;
+
+  fEndOfFile = false;
+  fStop = false;
+  fThread = std::thread(&NuEventReader::ReadAhead, this);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NuEventReader::Close()
+{
+  if ( fThread.joinable() ) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = true;
+    }
+    fNotFull.notify_all();
+    fThread.join();
+  }
+  fQueue.clear();
+  fEndOfFile = true;
+  if ( fInput.is_open() ) fInput.close();
+  fInput.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NuEventReader::Next(NuEvent& event)
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  fNotEmpty.wait(lock, [this] { return ! fQueue.empty() || fEndOfFile; });
+  if ( fQueue.empty() ) return false;
+
+  std::swap(event, fQueue.front());
+  fQueue.pop_front();
+  lock.unlock();
+  fNotFull.notify_one();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void NuEventReader::ReadAhead()
+{
+  // parse outside the lock, only the hand over to the queue is serialised
+  NuEvent event;
+  while ( true ) {
+    G4bool read = fBinary ? ReadBinary(event) : ReadHepMC(event);
+
+    std::unique_lock<std::mutex> lock(fMutex);
+    if ( ! read ) {
+      fEndOfFile = true;
+      lock.unlock();
+      fNotEmpty.notify_all();
+      return;
+    }
+    fNotFull.wait(lock, [this] { return fQueue.size() < fCapacity || fStop; });
+    if ( fStop ) return;
+    fQueue.push_back(std::move(event));
+    lock.unlock();
+    fNotEmpty.notify_one();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NuEventReader::ReadBinary(NuEvent& event)
+{
+  NuEventRecord record;
+  fInput.read(reinterpret_cast<char*>(&record), sizeof(record));
+  if ( fInput.gcount() != sizeof(record) || record.nofParticles < 0 ) return false;
+
+  event.number = record.number;
+  event.pdgNu = record.pdgNu;
+  event.pdgLep = record.pdgLep;
+  event.cc = record.cc;
+  event.eNu = record.eNu;
+  event.pLep = record.pLep;
+  event.x = record.x;
+  event.y = record.y;
+  event.z = record.z;
+  event.weight = record.weight;
+
+  std::vector<NuParticleRecord> particles(record.nofParticles);
+  std::streamsize size = particles.size()*sizeof(NuParticleRecord);
+  fInput.read(reinterpret_cast<char*>(particles.data()), size);
+  if ( fInput.gcount() != size ) return false;
+
+  event.particles.resize(particles.size());
+  for (std::size_t i = 0; i < particles.size(); ++i) {
+    event.particles[i] = { particles[i].pdg,
+      particles[i].px, particles[i].py, particles[i].pz };
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool NuEventReader::ReadHepMC(NuEvent& event)
+{
+  // the E line of this event was read ahead with the previous event
+  while ( fPendingLine.empty() || fPendingLine[0] != 'E' ) {
+    if ( ! std::getline(fInput, fPendingLine) ) return false;
+  }
+
+  // E number mpi scale aQCD aQED process signalVertex nofVertices
+  //   beam1 beam2 nofRandom [random states] nofWeights [weights]
+  std::istringstream eventLine(fPendingLine.substr(1));
+  G4int mpi, process, signalVertex, nofVertices, beam1, beam2, nofRandom = 0;
+  G4int nofWeights = 0;
+  G4double scale, alphaQCD, alphaQED;
+  eventLine >> event.number >> mpi >> scale >> alphaQCD >> alphaQED >> process
+            >> signalVertex >> nofVertices >> beam1 >> beam2 >> nofRandom;
+  for (G4int i = 0; i < nofRandom; ++i) {
+    long state;
+    eventLine >> state;
+  }
+  event.weight = 1.;
+  if ( ( eventLine >> nofWeights ) && nofWeights > 0 ) eventLine >> event.weight;
+
+  event.pdgNu = 0;
+  event.eNu = 0.;
+  event.x = event.y = event.z = 0.;
+  event.particles.clear();
+  G4bool vertexSet = false;
+
+  std::string line;
+  fPendingLine.clear();
+  while ( std::getline(fInput, line) ) {
+    if ( line.empty() ) continue;
+    // the next event or the end of the listing, H, F and C records of the
+    // heavy ion, PDF and cross section information are skipped below
+    if ( line[0] == 'E' || line.compare(0, 7, "HepMC::") == 0 ) {
+      fPendingLine = line;
+      break;
+    }
+    std::istringstream fields(line.substr(1));
+    if ( line[0] == 'U' ) {
+      // U energyUnit lengthUnit
+      std::string energyUnit, lengthUnit;
+      fields >> energyUnit >> lengthUnit;
+      fEnergyUnit = ( energyUnit == "MEV" ) ? 1.e-3 : 1.;
+      fLengthUnit = ( lengthUnit == "CM" ) ? 1. : 0.1;
+    }
+    else if ( line[0] == 'V' && ! vertexSet ) {
+      // V barcode id x y z ctau ...
+      G4int barcode, vertexId;
+      G4double x, y, z;
+      if ( fields >> barcode >> vertexId >> x >> y >> z ) {
+        event.x = x*fLengthUnit;
+        event.y = y*fLengthUnit;
+        event.z = z*fLengthUnit;
+        vertexSet = true;
+      }
+    }
+    else if ( line[0] == 'P' ) {
+      // P barcode pdg px py pz e m status ...
+      G4int barcode, pdg, status;
+      G4double px, py, pz, e, m;
+      if ( ! ( fields >> barcode >> pdg >> px >> py >> pz >> e >> m >> status ) ) continue;
+      G4int flavour = std::abs(pdg);
+      if ( status == 1 ) {
+        event.particles.push_back({ pdg, px*fEnergyUnit, py*fEnergyUnit, pz*fEnergyUnit });
+      }
+      else if ( ! event.pdgNu && ( flavour == 12 || flavour == 14 || flavour == 16 ) ) {
+        event.pdgNu = pdg;
+        event.eNu = e*fEnergyUnit;
+      }
+    }
+  }
+
+  SetInteraction(event);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,154 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file OverlapChecker.cc
+/// \brief Implementation of the OverlapChecker class
+
+#include "OverlapChecker.hh"
+
+#include "G4PhysicalVolumeStore.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4Timer.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4ios.hh"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlapChecker::OverlapChecker()
+ : fCacheFile("FASERnu_overlaps.txt")
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+OverlapChecker::~OverlapChecker()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool OverlapChecker::Check(const G4String& geometryHash, G4int resolution,
+                             G4double tolerance, G4int nofThreads)
+{
+  // placements only, replicas are not checked by Geant4 and the world
+  // has no mother
+  std::vector<G4VPhysicalVolume*> volumes;
+  for (auto volume : *G4PhysicalVolumeStore::GetInstance()) {
+    if ( volume->GetMotherLogical() && ! volume->IsReplicated() ) {
+      volumes.push_back(volume);
+    }
+  }
+
+  if ( nofThreads <= 0 ) nofThreads = std::thread::hardware_concurrency();
+  if ( nofThreads <= 0 ) nofThreads = 1;
+  if ( nofThreads > G4int(volumes.size()) ) nofThreads = volumes.size();
+
+  G4cout << G4endl << "---> Checking " << volumes.size()
+         << " placements for overlaps on " << nofThreads << " threads, "
+         << resolution << " points, tolerance " << tolerance/mm << " mm" << G4endl;
+
+  // CheckOverlaps() only reads the geometry, which is closed and not
+  // modified while the threads run, except for the surface areas and
+  // volumes the solids compute on first use to sample their surface: they
+  // are computed here first, so that the threads do not race to fill them.
+  // The random points come from the engine of each thread, and the reports
+  // of an overlap are JustWarning G4Exceptions, printed by each thread
+  // through its own G4cout and state manager without an exception handler.
+  for (auto volume : volumes) {
+    for (auto solid : { volume->GetLogicalVolume()->GetSolid(),
+                        volume->GetMotherLogical()->GetSolid() }) {
+      solid->GetSurfaceArea();
+      solid->GetCubicVolume();
+    }
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::vector<G4String> overlapping;
+  std::mutex mutex;
+  auto checkVolumes = [&]() {
+    G4iosInitialization();
+    std::size_t i;
+    while ( ( i = next++ ) < volumes.size() ) {
+      if ( volumes[i]->CheckOverlaps(resolution, tolerance, false, 1) ) {
+        std::lock_guard<std::mutex> lock(mutex);
+        overlapping.push_back(volumes[i]->GetName());
+      }
+    }
+    G4iosFinalization();
+  };
+
+  G4Timer timer;
+  timer.Start();
+  std::vector<std::thread> threads;
+  for (G4int i = 0; i < nofThreads; ++i) threads.emplace_back(checkVolumes);
+  for (auto& thread : threads) thread.join();
+  timer.Stop();
+
+  G4bool pass = overlapping.empty();
+  G4cout << "---> Overlap check " << ( pass ? "passed" : "FAILED" )
+         << " in " << timer.GetRealElapsed() << " s";
+  if ( ! pass ) {
+    G4cout << ", overlapping:";
+    for (const auto& name : overlapping) G4cout << " " << name;
+  }
+  G4cout << G4endl;
+
+  if ( fCacheFile.size() ) {
+    std::ofstream cache(fCacheFile, std::ios::app);
+    cache << geometryHash << " " << resolution << " " << tolerance/mm << " "
+          << ( pass ? "pass" : "fail" ) << std::endl;
+  }
+  return pass;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int OverlapChecker::GetCachedResult(const G4String& geometryHash) const
+{
+  std::ifstream cache(fCacheFile);
+  if ( ! cache.is_open() ) return -1;
+
+  G4int result = -1;
+  std::string line;
+  while ( std::getline(cache, line) ) {
+    std::istringstream fields(line);
+    std::string hash, outcome;
+    G4int resolution;
+    G4double tolerance;
+    if ( ! ( fields >> hash >> resolution >> tolerance >> outcome ) ) continue;
+    if ( hash == geometryHash ) result = ( outcome == "pass" ) ? 1 : 0;
+  }
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
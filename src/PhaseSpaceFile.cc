@@ -0,0 +1,215 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PhaseSpaceFile.cc
+/// \brief Implementation of the phase space file classes
+
+#include "PhaseSpaceFile.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  struct PhaseSpaceHeader
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t nofRecords;
+    std::uint64_t nofEvents;
+  };
+
+  const char kMagic[8] = { 'F','N','U','P','H','S','P','\0' };
+  const std::uint32_t kVersion = 1;
+
+  static_assert(sizeof(PhaseSpaceRecord) == 52, "PhaseSpaceRecord must be 52 bytes");
+  static_assert(sizeof(PhaseSpaceHeader) == 32, "header must be 32 bytes");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceWriter::PhaseSpaceWriter()
+ : fFileName(""),
+   fNofRecords(0),
+   fNofEvents(0),
+   fKillAtBoundary(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceWriter::~PhaseSpaceWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceWriter::Open(const G4String& fileName, G4bool killAtBoundary)
+{
+  Close();
+  fOutput.open(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! fOutput.is_open() ) return false;
+
+  // the counts are filled in by Close()
+  PhaseSpaceHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.recordSize = sizeof(PhaseSpaceRecord);
+  fOutput.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fFileName = fileName;
+  fNofRecords = 0;
+  fNofEvents = 0;
+  fKillAtBoundary = killAtBoundary;
+  return fOutput.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Write(const std::vector<PhaseSpaceRecord>& records)
+{
+  ++fNofEvents;
+  if ( records.empty() ) return;
+
+  std::lock_guard<std::mutex> lock(fMutex);
+  fOutput.write(reinterpret_cast<const char*>(records.data()),
+                records.size()*sizeof(PhaseSpaceRecord));
+  fNofRecords += records.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceWriter::Close()
+{
+  if ( ! fOutput.is_open() ) return;
+
+  std::uint64_t nofEvents = fNofEvents;
+  fOutput.seekp(offsetof(PhaseSpaceHeader, nofRecords));
+  fOutput.write(reinterpret_cast<const char*>(&fNofRecords), sizeof(fNofRecords));
+  fOutput.write(reinterpret_cast<const char*>(&nofEvents), sizeof(nofEvents));
+  fOutput.close();
+  fFileName = "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceReader::PhaseSpaceReader()
+ : fFileName(""),
+   fMap(nullptr),
+   fMapSize(0),
+   fRecords(nullptr),
+   fNofRecords(0),
+   fNofGeneratedEvents(0),
+   fEventStart(1, 0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhaseSpaceReader::~PhaseSpaceReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PhaseSpaceReader::Open(const G4String& fileName)
+{
+  Close();
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if ( fd < 0 ) return false;
+
+  struct stat status;
+  if ( fstat(fd, &status) != 0
+       || status.st_size < static_cast<off_t>(sizeof(PhaseSpaceHeader)) ) {
+    close(fd);
+    return false;
+  }
+
+  fMapSize = status.st_size;
+  fMap = mmap(nullptr, fMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if ( fMap == MAP_FAILED ) {
+    fMap = nullptr;
+    fMapSize = 0;
+    return false;
+  }
+
+  const auto header = static_cast<const PhaseSpaceHeader*>(fMap);
+  std::uint64_t available
+    = (fMapSize-sizeof(PhaseSpaceHeader))/sizeof(PhaseSpaceRecord);
+  if ( std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0
+       || header->version != kVersion
+       || header->recordSize != sizeof(PhaseSpaceRecord)
+       || header->nofRecords > available ) {
+    Close();
+    return false;
+  }
+
+  fFileName = fileName;
+  fNofRecords = header->nofRecords;
+  fNofGeneratedEvents = header->nofEvents;
+  fRecords = reinterpret_cast<const PhaseSpaceRecord*>(
+               static_cast<const char*>(fMap) + sizeof(PhaseSpaceHeader));
+
+  // the records of an event were written together
+  fEventStart.clear();
+  for (std::uint64_t i = 0; i < fNofRecords; ++i) {
+    if ( i == 0 || fRecords[i].event != fRecords[i-1].event
+                || fRecords[i].run != fRecords[i-1].run ) fEventStart.push_back(i);
+  }
+  fEventStart.push_back(fNofRecords);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceReader::Close()
+{
+  if ( fMap ) munmap(fMap, fMapSize);
+  fFileName = "";
+  fMap = nullptr;
+  fMapSize = 0;
+  fRecords = nullptr;
+  fNofRecords = 0;
+  fNofGeneratedEvents = 0;
+  fEventStart.assign(1, 0);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhaseSpaceInfo::Print() const
+{
+  G4cout << "replayed particle, stage-1 parent " << fParent << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file PrimaryStream.cc
+/// \brief Implementation of the primary stream file classes
+
+#include "PrimaryStream.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  struct PrimaryStreamHeader
+  {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t nofRecords;
+    std::uint64_t reserved;
+  };
+
+  const char kMagic[8] = { 'F','N','U','P','R','I','M','\0' };
+  const std::uint32_t kVersion = 1;
+
+  static_assert(sizeof(PrimaryRecord) == 32, "PrimaryRecord must be 32 bytes");
+  static_assert(sizeof(PrimaryStreamHeader) == 32, "header must be 32 bytes");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryStreamWriter::PrimaryStreamWriter()
+ : fNofRecords(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryStreamWriter::~PrimaryStreamWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PrimaryStreamWriter::Open(const G4String& fileName)
+{
+  Close();
+  fOutput.open(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! fOutput.is_open() ) return false;
+
+  // the record count is filled in by Close()
+  PrimaryStreamHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.recordSize = sizeof(PrimaryRecord);
+  fOutput.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fNofRecords = 0;
+  return fOutput.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryStreamWriter::Write(const PrimaryRecord& record)
+{
+  fOutput.write(reinterpret_cast<const char*>(&record), sizeof(record));
+  ++fNofRecords;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryStreamWriter::Close()
+{
+  if ( ! fOutput.is_open() ) return;
+
+  fOutput.seekp(offsetof(PrimaryStreamHeader, nofRecords));
+  fOutput.write(reinterpret_cast<const char*>(&fNofRecords), sizeof(fNofRecords));
+  fOutput.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryStreamReader::PrimaryStreamReader()
+ : fFileName(""),
+   fMap(nullptr),
+   fMapSize(0),
+   fRecords(nullptr),
+   fNofRecords(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PrimaryStreamReader::~PrimaryStreamReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool PrimaryStreamReader::Open(const G4String& fileName)
+{
+  Close();
+
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if ( fd < 0 ) return false;
+
+  struct stat status;
+  if ( fstat(fd, &status) != 0
+       || status.st_size < static_cast<off_t>(sizeof(PrimaryStreamHeader)) ) {
+    close(fd);
+    return false;
+  }
+
+  fMapSize = status.st_size;
+  fMap = mmap(nullptr, fMapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if ( fMap == MAP_FAILED ) {
+    fMap = nullptr;
+    fMapSize = 0;
+    return false;
+  }
+
+  const auto header = static_cast<const PrimaryStreamHeader*>(fMap);
+  std::uint64_t available
+    = (fMapSize-sizeof(PrimaryStreamHeader))/sizeof(PrimaryRecord);
+  if ( std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0
+       || header->version != kVersion
+       || header->recordSize != sizeof(PrimaryRecord)
+       || header->nofRecords > available ) {
+    Close();
+    return false;
+  }
+
+  fFileName = fileName;
+  fNofRecords = header->nofRecords;
+  fRecords = reinterpret_cast<const PrimaryRecord*>(
+               static_cast<const char*>(fMap) + sizeof(PrimaryStreamHeader));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PrimaryStreamReader::Close()
+{
+  if ( fMap ) munmap(fMap, fMapSize);
+  fFileName = "";
+  fMap = nullptr;
+  fMapSize = 0;
+  fRecords = nullptr;
+  fNofRecords = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
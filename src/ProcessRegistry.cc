@@ -0,0 +1,97 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ProcessRegistry.cc
+/// \brief Implementation of the ProcessRegistry class
+
+#include "ProcessRegistry.hh"
+#include "Analysis.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4VProcess.hh"
+
+#include <map>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessRegistry::ProcessRegistry()
+ : fIds(),
+   fNames(1, "none"),
+   fLastProcess(nullptr),
+   fLastId(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ProcessRegistry::~ProcessRegistry()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProcessRegistry::Build()
+{
+  // the processes of this thread, gathered by name
+  std::map<G4String, std::vector<const G4VProcess*> > byName;
+  auto particleIterator = G4ParticleTable::GetParticleTable()->GetIterator();
+  particleIterator->reset();
+  while ( (*particleIterator)() ) {
+    auto processManager = particleIterator->value()->GetProcessManager();
+    if ( ! processManager ) continue;
+    G4ProcessVector* processes = processManager->GetProcessList();
+    for (std::size_t i = 0; i < std::size_t(processes->size()); ++i) {
+      const G4VProcess* process = (*processes)[i];
+      byName[process->GetProcessName()].push_back(process);
+    }
+  }
+
+  // ids in the order of the names, the same on every thread
+  fIds.clear();
+  fNames.assign(1, "none");
+  fIds[nullptr] = 0;
+  for (const auto& entry : byName) {
+    G4int id = fNames.size();
+    fNames.push_back(entry.first);
+    for (auto process : entry.second) fIds[process] = id;
+  }
+  fLastProcess = nullptr;
+  fLastId = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ProcessRegistry::FillNtuple(G4int ntupleId) const
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  for (std::size_t id = 0; id < fNames.size(); ++id) {
+    analysisManager->FillNtupleIColumn(ntupleId, 0, id);
+    analysisManager->FillNtupleSColumn(ntupleId, 1, fNames[id]);
+    analysisManager->AddNtupleRow(ntupleId);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,398 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RockTables.cc
+/// \brief Implementation of the RockTables class
+
+#include "RockTables.hh"
+#include "HistogramSampler.hh"
+
+#include "G4Poisson.hh"
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  const G4int kVersion = 1;
+
+  // entry energy, log10(E/GeV)
+  const G4int    kNofEnergyBins = 40;
+  const G4double kLogEnergyMin = 0.;
+  const G4double kLogEnergyMax = 4.;
+
+  // exit/entry energy ratio in [0,1]
+  const G4int    kNofRatioBins = 200;
+
+  // deflection angle times entry energy, mrad*GeV
+  const G4int    kNofAngleBins = 250;
+  const G4double kAngleMax = 1000.;
+
+  // log10 of the secondary energy over the muon entry energy
+  const G4int    kNofSecondaryBins = 70;
+  const G4double kLogFractionMin = -7.;
+  const G4double kLogFractionMax = 0.;
+
+  // secondaries emitted at the exit face, others are not parametrized
+  const G4int kSpecies[] = { 22, 11, -11, 2112, 2212, 211, -211, 321, -321, 130 };
+  const G4int kNofSpecies = sizeof(kSpecies)/sizeof(kSpecies[0]);
+
+  // calibrated muons needed in an energy bin to use it
+  const G4double kMinMuons = 100.;
+
+  G4int FindBin(G4double value, G4double min, G4double max, G4int nofBins)
+  {
+    G4int bin = static_cast<G4int>(std::floor((value-min)/(max-min)*nofBins));
+    return std::min(std::max(bin, 0), nofBins-1);
+  }
+
+  std::vector<G4double> Edges(G4double min, G4double max, G4int nofBins)
+  {
+    std::vector<G4double> edges(nofBins+1);
+    for (G4int i = 0; i <= nofBins; ++i) edges[i] = min + (max-min)*i/nofBins;
+    return edges;
+  }
+
+  std::vector<G4double> Slice(const std::vector<G4double>& values,
+                              G4int first, G4int size)
+  {
+    return std::vector<G4double>(values.begin()+first, values.begin()+first+size);
+  }
+
+  void WriteLine(std::ostream& output, const char* key,
+                 const std::vector<G4double>& values)
+  {
+    output << key;
+    for (auto value : values) output << ' ' << value;
+    output << '\n';
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RockTables::RockTables()
+ : G4VAccumulable("RockTables"),
+   fMuons(kNofEnergyBins, 0.),
+   fStopped(kNofEnergyBins, 0.),
+   fPathSum(kNofEnergyBins, 0.),
+   fRatio(kNofEnergyBins*kNofRatioBins, 0.),
+   fAngle(kNofEnergyBins*kNofAngleBins, 0.),
+   fYield(kNofEnergyBins*kNofSpecies, 0.),
+   fSecondary(kNofEnergyBins*kNofSpecies*kNofSecondaryBins, 0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RockTables::~RockTables()
+{
+  DeleteSamplers();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int RockTables::GetNofSpecies()
+{
+  return kNofSpecies;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int RockTables::GetSpeciesPDG(G4int species)
+{
+  return kSpecies[species];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RockTables::GetNofMuons() const
+{
+  G4double sum = 0.;
+  for (auto muons : fMuons) sum += muons;
+  return sum;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int RockTables::GetEnergyBin(G4double entryEnergy) const
+{
+  if ( ! ( entryEnergy > 0. ) ) return -1;
+  G4double logEnergy = std::log10(entryEnergy/GeV);
+  if ( logEnergy < kLogEnergyMin || logEnergy >= kLogEnergyMax ) return -1;
+  return FindBin(logEnergy, kLogEnergyMin, kLogEnergyMax, kNofEnergyBins);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::FillMuon(G4double entryEnergy, G4double path,
+                          G4double exitEnergy, G4double angle)
+{
+  G4int bin = GetEnergyBin(entryEnergy);
+  if ( bin < 0 ) return;
+
+  fMuons[bin] += 1.;
+  if ( ! ( exitEnergy > 0. ) ) {
+    fStopped[bin] += 1.;
+    return;
+  }
+  fPathSum[bin] += path/mm;
+
+  G4int ratioBin = FindBin(exitEnergy/entryEnergy, 0., 1., kNofRatioBins);
+  fRatio[bin*kNofRatioBins + ratioBin] += 1.;
+
+  G4double scaledAngle = (angle/mrad)*(entryEnergy/GeV);
+  G4int angleBin = FindBin(scaledAngle, 0., kAngleMax, kNofAngleBins);
+  fAngle[bin*kNofAngleBins + angleBin] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::FillSecondary(G4double entryEnergy, G4int pdg, G4double energy)
+{
+  G4int bin = GetEnergyBin(entryEnergy);
+  if ( bin < 0 || ! ( energy > 0. ) ) return;
+
+  G4int species = std::find(kSpecies, kSpecies+kNofSpecies, pdg) - kSpecies;
+  if ( species == kNofSpecies ) return;
+
+  G4double logFraction = std::log10(energy/entryEnergy);
+  if ( logFraction < kLogFractionMin ) return;
+
+  G4int index = bin*kNofSpecies + species;
+  fYield[index] += 1.;
+  G4int fractionBin
+    = FindBin(logFraction, kLogFractionMin, kLogFractionMax, kNofSecondaryBins);
+  fSecondary[index*kNofSecondaryBins + fractionBin] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::Merge(const G4VAccumulable& other)
+{
+  auto& tables = static_cast<const RockTables&>(other);
+  auto add = [](std::vector<G4double>& to, const std::vector<G4double>& from) {
+    for (std::size_t i = 0; i < to.size(); ++i) to[i] += from[i];
+  };
+  add(fMuons, tables.fMuons);
+  add(fStopped, tables.fStopped);
+  add(fPathSum, tables.fPathSum);
+  add(fRatio, tables.fRatio);
+  add(fAngle, tables.fAngle);
+  add(fYield, tables.fYield);
+  add(fSecondary, tables.fSecondary);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::Reset()
+{
+  for (auto values : { &fMuons, &fStopped, &fPathSum, &fRatio, &fAngle,
+                       &fYield, &fSecondary }) {
+    std::fill(values->begin(), values->end(), 0.);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RockTables::Write(const G4String& fileName) const
+{
+  std::ofstream output(fileName);
+  if ( ! output.is_open() ) return false;
+
+  // binning first, checked against this build when read back
+  output << "# FASERnu rock transport tables, " << GetNofMuons() << " muons\n"
+         << "version " << kVersion << '\n'
+         << "energy " << kNofEnergyBins << ' ' << kLogEnergyMin << ' '
+         << kLogEnergyMax << '\n'
+         << "ratio " << kNofRatioBins << '\n'
+         << "angle " << kNofAngleBins << ' ' << kAngleMax << '\n'
+         << "secondary " << kNofSecondaryBins << ' ' << kLogFractionMin << ' '
+         << kLogFractionMax << '\n'
+         << "species " << kNofSpecies;
+  for (auto pdg : kSpecies) output << ' ' << pdg;
+  output << '\n' << std::setprecision(12);
+
+  WriteLine(output, "muons", fMuons);
+  WriteLine(output, "stopped", fStopped);
+  WriteLine(output, "path", fPathSum);
+  WriteLine(output, "ratios", fRatio);
+  WriteLine(output, "angles", fAngle);
+  WriteLine(output, "yields", fYield);
+  WriteLine(output, "secondaries", fSecondary);
+  return output.good();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RockTables::Read(const G4String& fileName)
+{
+  std::ifstream input(fileName);
+  if ( ! input.is_open() ) return false;
+
+  std::map<std::string, std::vector<G4double> > lines;
+  std::string line;
+  while ( std::getline(input, line) ) {
+    auto hash = line.find('#');
+    if ( hash != std::string::npos ) line.erase(hash);
+    std::istringstream fields(line);
+    std::string key;
+    if ( ! ( fields >> key ) ) continue;
+    auto& values = lines[key];
+    G4double value;
+    while ( fields >> value ) values.push_back(value);
+  }
+
+  std::vector<G4double> species(1, kNofSpecies);
+  species.insert(species.end(), kSpecies, kSpecies+kNofSpecies);
+  if ( lines["version"] != std::vector<G4double>{ G4double(kVersion) }
+       || lines["energy"] != std::vector<G4double>{ G4double(kNofEnergyBins),
+                                                    kLogEnergyMin, kLogEnergyMax }
+       || lines["ratio"] != std::vector<G4double>{ G4double(kNofRatioBins) }
+       || lines["angle"] != std::vector<G4double>{ G4double(kNofAngleBins), kAngleMax }
+       || lines["secondary"] != std::vector<G4double>{ G4double(kNofSecondaryBins),
+                                                       kLogFractionMin, kLogFractionMax }
+       || lines["species"] != species ) return false;
+
+  if ( lines["muons"].size() != fMuons.size()
+       || lines["stopped"].size() != fStopped.size()
+       || lines["path"].size() != fPathSum.size()
+       || lines["ratios"].size() != fRatio.size()
+       || lines["angles"].size() != fAngle.size()
+       || lines["yields"].size() != fYield.size()
+       || lines["secondaries"].size() != fSecondary.size() ) return false;
+
+  fMuons = lines["muons"];
+  fStopped = lines["stopped"];
+  fPathSum = lines["path"];
+  fRatio = lines["ratios"];
+  fAngle = lines["angles"];
+  fYield = lines["yields"];
+  fSecondary = lines["secondaries"];
+  BuildSamplers();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::DeleteSamplers()
+{
+  for (auto samplers : { &fRatioSamplers, &fAngleSamplers, &fSecondarySamplers }) {
+    for (auto sampler : *samplers) delete sampler;
+    samplers->clear();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTables::BuildSamplers()
+{
+  DeleteSamplers();
+  fRatioSamplers.resize(kNofEnergyBins, nullptr);
+  fAngleSamplers.resize(kNofEnergyBins, nullptr);
+  fSecondarySamplers.resize(kNofEnergyBins*kNofSpecies, nullptr);
+
+  // bins without entries keep no sampler, they are never drawn from
+  auto ratioEdges = Edges(0., 1., kNofRatioBins);
+  auto angleEdges = Edges(0., kAngleMax, kNofAngleBins);
+  auto secondaryEdges = Edges(kLogFractionMin, kLogFractionMax, kNofSecondaryBins);
+  for (G4int bin = 0; bin < kNofEnergyBins; ++bin) {
+    if ( fMuons[bin] > fStopped[bin] ) {
+      fRatioSamplers[bin] = new HistogramSampler(
+        ratioEdges, Slice(fRatio, bin*kNofRatioBins, kNofRatioBins));
+      fAngleSamplers[bin] = new HistogramSampler(
+        angleEdges, Slice(fAngle, bin*kNofAngleBins, kNofAngleBins));
+    }
+    for (G4int species = 0; species < kNofSpecies; ++species) {
+      G4int index = bin*kNofSpecies + species;
+      if ( ! ( fYield[index] > 0. ) ) continue;
+      fSecondarySamplers[index] = new HistogramSampler(
+        secondaryEdges,
+        Slice(fSecondary, index*kNofSecondaryBins, kNofSecondaryBins));
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RockTables::Covers(G4double entryEnergy) const
+{
+  if ( fRatioSamplers.empty() ) return false;
+  G4int bin = GetEnergyBin(entryEnergy);
+  return bin >= 0 && fMuons[bin] >= kMinMuons;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RockTables::ShootExitEnergy(G4double entryEnergy, G4double path) const
+{
+  G4int bin = GetEnergyBin(entryEnergy);
+  if ( G4UniformRand()*fMuons[bin] < fStopped[bin] ) return 0.;
+
+  // the loss rate is kept for a path other than the calibrated one
+  G4double ratio = fRatioSamplers[bin]->Shoot();
+  G4double meanPath = fPathSum[bin]*mm/(fMuons[bin]-fStopped[bin]);
+  if ( meanPath > 0. ) ratio = std::pow(ratio, path/meanPath);
+  return ratio*entryEnergy;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RockTables::ShootAngle(G4double entryEnergy, G4double path) const
+{
+  // multiple scattering, the angle grows as the square root of the path
+  G4int bin = GetEnergyBin(entryEnergy);
+  G4double angle = fAngleSamplers[bin]->Shoot()*mrad/(entryEnergy/GeV);
+  G4double meanPath = fPathSum[bin]*mm/(fMuons[bin]-fStopped[bin]);
+  if ( meanPath > 0. ) angle *= std::sqrt(path/meanPath);
+  return angle;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int RockTables::ShootNofSecondaries(G4double entryEnergy, G4int species) const
+{
+  G4int bin = GetEnergyBin(entryEnergy);
+  G4double mean = fYield[bin*kNofSpecies + species]/fMuons[bin];
+  return ( mean > 0. ) ? G4Poisson(mean) : 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double RockTables::ShootSecondaryEnergy(G4double entryEnergy, G4int species) const
+{
+  G4int bin = GetEnergyBin(entryEnergy);
+  auto sampler = fSecondarySamplers[bin*kNofSpecies + species];
+  if ( ! sampler ) return 0.;
+  return entryEnergy*std::pow(10., sampler->Shoot());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,156 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file RockTransportModel.cc
+/// \brief Implementation of the RockTransportModel class
+
+#include "RockTransportModel.hh"
+#include "RockTables.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4FastTrack.hh"
+#include "G4FastStep.hh"
+#include "G4VSolid.hh"
+#include "G4DynamicParticle.hh"
+#include "G4ParticleTable.hh"
+#include "G4MuonMinus.hh"
+#include "G4MuonPlus.hh"
+#include "G4PhysicalConstants.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RockTransportModel::RockTransportModel(const G4String& name, G4Region* envelope,
+                                       const DetectorConstruction* detector)
+ : G4VFastSimulationModel(name, envelope),
+   fDetector(detector)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RockTransportModel::~RockTransportModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RockTransportModel::IsApplicable(const G4ParticleDefinition& particle)
+{
+  return &particle == G4MuonMinus::MuonMinusDefinition()
+      || &particle == G4MuonPlus::MuonPlusDefinition();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool RockTransportModel::ModelTrigger(const G4FastTrack& fastTrack)
+{
+  if ( fDetector->GetRockMode() != DetectorConstruction::kRockFast ) return false;
+
+  auto energy = fastTrack.GetPrimaryTrack()->GetKineticEnergy();
+  if ( ! fDetector->GetRockTables()->Covers(energy) ) return false;
+
+  // on the surface moving in: a muon starting inside the rock, or one
+  // already moved to the exit by DoIt(), is left alone
+  auto solid = fastTrack.GetEnvelopeSolid();
+  const auto& position = fastTrack.GetPrimaryTrackLocalPosition();
+  const auto& direction = fastTrack.GetPrimaryTrackLocalDirection();
+  return solid->Inside(position) == kSurface
+      && solid->SurfaceNormal(position).dot(direction) < 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RockTransportModel::DoIt(const G4FastTrack& fastTrack, G4FastStep& fastStep)
+{
+  auto tables = fDetector->GetRockTables();
+  auto track = fastTrack.GetPrimaryTrack();
+  auto solid = fastTrack.GetEnvelopeSolid();
+  G4double energy = track->GetKineticEnergy();
+  G4ThreeVector position = fastTrack.GetPrimaryTrackLocalPosition();
+  G4ThreeVector direction = fastTrack.GetPrimaryTrackLocalDirection();
+  G4double path = solid->DistanceToOut(position, direction);
+
+  G4double exitEnergy = tables->ShootExitEnergy(energy, path);
+  if ( ! ( exitEnergy > 0. ) ) {
+    fastStep.KillPrimaryTrack();
+    fastStep.ProposeTotalEnergyDeposited(energy);
+    return;
+  }
+
+  // deflection in a random plane containing the direction
+  G4double angle = tables->ShootAngle(energy, path);
+  G4ThreeVector transverse = direction.orthogonal().unit();
+  transverse.rotate(twopi*G4UniformRand(), direction);
+  G4ThreeVector exitDirection
+    = ( std::cos(angle)*direction + std::sin(angle)*transverse ).unit();
+
+  // the displaced track leaves along the entry direction, so that the
+  // exit point is on the rock surface whatever its shape
+  G4ThreeVector start = position + 0.5*path*angle*transverse;
+  if ( solid->Inside(start) == kOutside ) start = position;
+  G4ThreeVector exitPosition = start + solid->DistanceToOut(start, direction)*direction;
+  if ( solid->SurfaceNormal(exitPosition).dot(exitDirection) <= 0. ) {
+    exitDirection = direction;
+  }
+  G4double exitTime = track->GetGlobalTime() + path/c_light;
+
+  fastStep.ProposePrimaryTrackFinalPosition(exitPosition);
+  fastStep.ProposePrimaryTrackFinalMomentumDirection(exitDirection);
+  fastStep.ProposePrimaryTrackFinalKineticEnergy(exitEnergy);
+  fastStep.ProposePrimaryTrackFinalTime(exitTime);
+  fastStep.ProposePrimaryTrackPathLength(path);
+
+  // secondaries leaving the rock, along the muon
+  std::vector<std::pair<G4int, G4double> > secondaries;
+  for (G4int species = 0; species < RockTables::GetNofSpecies(); ++species) {
+    G4int nofSecondaries = tables->ShootNofSecondaries(energy, species);
+    for (G4int i = 0; i < nofSecondaries; ++i) {
+      G4double secondaryEnergy = tables->ShootSecondaryEnergy(energy, species);
+      if ( secondaryEnergy > 0. ) {
+        secondaries.push_back(
+          std::make_pair(RockTables::GetSpeciesPDG(species), secondaryEnergy));
+      }
+    }
+  }
+
+  G4double carried = exitEnergy;
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  fastStep.SetNumberOfSecondaryTracks(secondaries.size());
+  for (const auto& secondary : secondaries) {
+    auto particle = particleTable->FindParticle(secondary.first);
+    if ( ! particle ) continue;
+    G4DynamicParticle dynamic(particle, exitDirection, secondary.second);
+    fastStep.CreateSecondaryTrack(dynamic, exitPosition, exitTime);
+    carried += secondary.second;
+  }
+  fastStep.ProposeTotalEnergyDeposited(std::max(energy-carried, 0.));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
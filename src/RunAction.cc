@@ -28,19 +28,26 @@
 /// \brief Implementation of the RunAction class
 
 #include "RunAction.hh"
+#include "DetectorConstruction.hh"
+#include "ScoringPlanes.hh"
 #include "Analysis.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4GenericMessenger.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <iomanip>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4ThreadLocal double e_beam;
 G4ThreadLocal int pdg_beam;
 G4ThreadLocal double x_beam;
 G4ThreadLocal double y_beam;
+G4ThreadLocal double w_beam = 1.;
 
 G4ThreadLocal int pdg_primary;
 G4ThreadLocal double e_primary;
@@ -59,49 +66,14 @@ G4ThreadLocal int cc_nuEvt;
 G4ThreadLocal double x_nuEvt;
 G4ThreadLocal double y_nuEvt;
 G4ThreadLocal double z_nuEvt;
-G4ThreadLocal std::vector<int> cham;
-G4ThreadLocal std::vector<int> idz;
-G4ThreadLocal std::vector<int> idzsub;
-G4ThreadLocal std::vector<int> pdgid;
-G4ThreadLocal std::vector<int> id;
-G4ThreadLocal std::vector<int> idParent;
-G4ThreadLocal std::vector<double> charge;
-G4ThreadLocal std::vector<double> x;
-G4ThreadLocal std::vector<double> y;
-G4ThreadLocal std::vector<double> z;
-G4ThreadLocal std::vector<double> px;
-G4ThreadLocal std::vector<double> py;
-G4ThreadLocal std::vector<double> pz;
-G4ThreadLocal std::vector<double> e1;
-G4ThreadLocal std::vector<double> e2;
-G4ThreadLocal std::vector<double> len;
-G4ThreadLocal std::vector<double> edep;
-
-RunAction::RunAction()
- : G4UserRunAction()
-{ 
-  // set printing event number per each event
-  G4RunManager::GetRunManager()->SetPrintProgress(1);     
+G4ThreadLocal EmulsionHits emulsionHits;
+G4ThreadLocal ProcessRegistry processRegistry;
 
-  // Create analysis manager
-  // The choice of analysis technology is done via selectin of a namespace
-  // in Analysis.hh
-  auto analysisManager = G4AnalysisManager::Instance();
-  G4cout << "Using " << analysisManager->GetType() << G4endl;
-
-  // Create directories 
-  analysisManager->SetHistoDirectoryName("histo");
-  analysisManager->SetFirstHistoId(1);
-  //analysisManager->SetNtupleDirectoryName("ntuple");
-  analysisManager->SetVerboseLevel(1);
-  analysisManager->SetNtupleMerging(true);
-  // Note: merging ntuples is available only with Root output
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-  // Book histograms
-  const G4String idx[29] = {"h0","h1","h2","h3","h4","h5","h6","h7","h8","h9","h10","h11",
-			    "h12","h13","h14","h15","h16","h17","h18","h19","h20","h21",
-                            "h22","h23","h24","h25","h26","h27","h28"};
-  const G4String title[29] = 
+namespace {
+  // flux histograms of a scoring plane, by particle class
+  const char* kFluxTitles[29] = 
     { "dummy",                                                        //0
       "energy spectrum of primary",                                   //1
       "energy spectrum of emerging gamma",                            //2
@@ -132,37 +104,77 @@ RunAction::RunAction()
       "energy spectrum of all others emerging mesons",                //27
       "energy spectrum of all others emerging leptons (neutrinos)"    //28
     };
+}
 
-  for (G4int k=1; k<=28; k++) {
-    if(k==1) analysisManager->CreateH1(idx[k], title[k], 400, 110, 4110);
-    else if(k==2) analysisManager->CreateH1(idx[k], title[k], 200, 0, 200);
-    else if(k==3) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==4) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==5) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==6) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==7) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==8) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==9) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==10) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==11) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==12) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==13) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==14) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==15) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==16) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==17) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==18) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==19) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==20) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==21) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==22) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==23) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==24) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==25) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==26) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==27) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-    else if(k==28) analysisManager->CreateH1(idx[k], title[k], 500, 0, 500);
-  }
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+RunAction::RunAction(const ScoringPlanes* scoringPlanes)
+ : G4UserRunAction(),
+   fScoringPlanes(scoringPlanes),
+   fNofBookedPlanes(0),
+   fFluxFirstIds(),
+   fNofSteps(0),
+   fNofHits(0),
+   fNofHitSteps(0),
+   fRockTables(),
+   fStepFilter(),
+   fHistograms(),
+   fRangeKills("RangeKills"),
+   fStepProfiler(),
+   fMessenger(nullptr),
+   fProfileSteps(false),
+   fProfileFile("StepProfile.txt"),
+   fProfileRows(20),
+   fProcessNtupleId(-1),
+   fRockCalibration(false)
+{ 
+  // step and hit counts, rock tables and range rejection counts merged from the workers at the end of run
+  G4AccumulableManager::Instance()->RegisterAccumulable(fNofSteps);
+  G4AccumulableManager::Instance()->RegisterAccumulable(fNofHits);
+  G4AccumulableManager::Instance()->RegisterAccumulable(fNofHitSteps);
+  G4AccumulableManager::Instance()->RegisterAccumulable(fRockTables);
+  G4AccumulableManager::Instance()->RegisterAccumulable(fRangeKills);
+  G4AccumulableManager::Instance()->RegisterAccumulable(fStepProfiler);
+
+  // step profiling, switched in every thread
+  fMessenger = new G4GenericMessenger(this, "/FASERnu/profile/",
+                                      "Step and CPU accounting");
+  auto& stepsCmd = fMessenger->DeclareProperty("steps", fProfileSteps,
+    "Count steps, tracks and time per volume, particle and process.");
+  stepsCmd.SetParameterName("flag", true);
+  stepsCmd.SetDefaultValue("true");
+  stepsCmd.SetStates(G4State_PreInit, G4State_Idle);
+  auto& fileCmd = fMessenger->DeclareProperty("file", fProfileFile,
+    "Text file of the step profile table written at the end of run.");
+  fileCmd.SetParameterName("fileName", false);
+  fileCmd.SetStates(G4State_PreInit, G4State_Idle);
+  auto& rowsCmd = fMessenger->DeclareProperty("rows", fProfileRows,
+    "Number of rows of the step profile table printed at the end of run.");
+  rowsCmd.SetParameterName("nofRows", false);
+  rowsCmd.SetRange("nofRows>=0");
+  rowsCmd.SetStates(G4State_PreInit, G4State_Idle);
+
+  // set printing event number per each event
+  G4RunManager::GetRunManager()->SetPrintProgress(1);     
+
+  // Create analysis manager
+  // The choice of analysis technology is done via selectin of a namespace
+  // in Analysis.hh
+  auto analysisManager = G4AnalysisManager::Instance();
+  G4cout << "Using " << analysisManager->GetType() << G4endl;
+
+  // Create directories 
+  analysisManager->SetHistoDirectoryName("histo");
+  analysisManager->SetFirstHistoId(1);
+  //analysisManager->SetNtupleDirectoryName("ntuple");
+  analysisManager->SetVerboseLevel(1);
+  analysisManager->SetNtupleMerging(true);
+  // Note: merging ntuples is available only with Root output
+
+  // Book histograms of the absorber plane, those of the other scoring
+  // planes are booked at the start of run
+  BookFlux("");
+  fNofBookedPlanes = 1;
 
   // // Creating ntuple
   // //
@@ -180,6 +192,7 @@ RunAction::RunAction()
   // analysisManager->CreateNtupleDColumn("e_neutron");
   // analysisManager->CreateNtupleDColumn("x_neutron");
   // analysisManager->CreateNtupleDColumn("y_neutron");
+  // analysisManager->CreateNtupleDColumn("w_beam");
   
   //analysisManager->CreateNtupleIColumn("pdgnu_nuEvt");
   //analysisManager->CreateNtupleIColumn("pdglep_nuEvt");
@@ -189,36 +202,68 @@ RunAction::RunAction()
   //analysisManager->CreateNtupleDColumn("x_nuEvt");
   //analysisManager->CreateNtupleDColumn("y_nuEvt");
   //analysisManager->CreateNtupleDColumn("z_nuEvt");
-  //analysisManager->CreateNtupleIColumn("chamber",cham);
-  //analysisManager->CreateNtupleIColumn("iz",idz);
-  //analysisManager->CreateNtupleIColumn("izsub",idzsub);
-  //analysisManager->CreateNtupleIColumn("pdgid",pdgid);
-  //analysisManager->CreateNtupleIColumn("id",id);
-  //analysisManager->CreateNtupleIColumn("idParent",idParent);
-  //analysisManager->CreateNtupleDColumn("charge",charge);
-  //analysisManager->CreateNtupleDColumn("x",x);
-  //analysisManager->CreateNtupleDColumn("y",y);
-  //analysisManager->CreateNtupleDColumn("z",z);
-  //analysisManager->CreateNtupleDColumn("px",px);
-  //analysisManager->CreateNtupleDColumn("py",py);
-  //analysisManager->CreateNtupleDColumn("pz",pz);
-  //analysisManager->CreateNtupleDColumn("e1",e1);
-  //analysisManager->CreateNtupleDColumn("e2",e2);
-  //analysisManager->CreateNtupleDColumn("len",len);
-  //analysisManager->CreateNtupleDColumn("edep",edep);
+  //analysisManager->CreateNtupleIColumn("chamber",emulsionHits.cham);
+  //analysisManager->CreateNtupleIColumn("iz",emulsionHits.idz);
+  //analysisManager->CreateNtupleIColumn("izsub",emulsionHits.idzsub);
+  //analysisManager->CreateNtupleIColumn("pdgid",emulsionHits.pdgid);
+  //analysisManager->CreateNtupleIColumn("id",emulsionHits.id);
+  //analysisManager->CreateNtupleIColumn("idParent",emulsionHits.idParent);
+  //analysisManager->CreateNtupleDColumn("charge",emulsionHits.charge);
+  //analysisManager->CreateNtupleDColumn("x",emulsionHits.x);
+  //analysisManager->CreateNtupleDColumn("y",emulsionHits.y);
+  //analysisManager->CreateNtupleDColumn("z",emulsionHits.z);
+  //analysisManager->CreateNtupleDColumn("px",emulsionHits.px);
+  //analysisManager->CreateNtupleDColumn("py",emulsionHits.py);
+  //analysisManager->CreateNtupleDColumn("pz",emulsionHits.pz);
+  //analysisManager->CreateNtupleDColumn("e1",emulsionHits.e1);
+  //analysisManager->CreateNtupleDColumn("e2",emulsionHits.e2);
+  //analysisManager->CreateNtupleDColumn("len",emulsionHits.len);
+  //analysisManager->CreateNtupleDColumn("edep",emulsionHits.edep);
+  //analysisManager->CreateNtupleIColumn("proc",emulsionHits.proc);
   
   //analysisManager->FinishNtuple();
+
+  // names of the process identifiers of the proc column, filled by the
+  // master; to be booked with the hit ntuple above
+  //fProcessNtupleId
+  //  = analysisManager->CreateNtuple("Processes", "Process names of the hit process identifiers");
+  //analysisManager->CreateNtupleIColumn(fProcessNtupleId, "id");
+  //analysisManager->CreateNtupleSColumn(fProcessNtupleId, "name");
+  //analysisManager->FinishNtuple(fProcessNtupleId);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 RunAction::~RunAction()
 {
+  delete fMessenger;
   delete G4AnalysisManager::Instance();  
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void RunAction::BookFlux(const G4String& plane)
+{
+  // the absorber plane keeps the h1-h28 names of the original scoring
+  auto analysisManager = G4AnalysisManager::Instance();
+  G4String prefix, titlePrefix;
+  if ( plane.size() ) {
+    prefix = plane + "_";
+    titlePrefix = plane + ": ";
+  }
+  for (G4int k=1; k<=28; k++) {
+    G4String name = prefix + "h" + std::to_string(k);
+    G4String title = titlePrefix + kFluxTitles[k];
+    G4int id;
+    if(k==1) id = analysisManager->CreateH1(name, title, 400, 110, 4110);
+    else if(k==2) id = analysisManager->CreateH1(name, title, 200, 0, 200);
+    else id = analysisManager->CreateH1(name, title, 500, 0, 500);
+    if(k==1) fFluxFirstIds.push_back(id);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
 void RunAction::BeginOfRunAction(const G4Run* /*run*/)
 { 
   //inform the runManager to save random number seed
@@ -227,19 +272,132 @@ void RunAction::BeginOfRunAction(const G4Run* /*run*/)
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
 
+  // histograms of the scoring planes added since the last run
+  if ( fScoringPlanes ) {
+    for (; fNofBookedPlanes < fScoringPlanes->GetNofPlanes(); ++fNofBookedPlanes) {
+      BookFlux(fScoringPlanes->GetPlane(fNofBookedPlanes).name);
+    }
+  }
+
   // Open an output file
   //
   //G4String fileName = "FASERnuPilot";
   analysisManager->OpenFile();
+  fHistograms.Attach();
+
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fRockCalibration = ( detector->GetRockMode() == DetectorConstruction::kRockCalibrate );
+  G4int nofMissing = fStepFilter.Resolve(fScoringPlanes, fFluxFirstIds);
+  processRegistry.Build();
+  if ( IsMaster() && nofMissing > 0 ) {
+    G4ExceptionDescription msg;
+    msg << nofMissing << " scoring planes have volumes not in the geometry"
+        << " and are not scored.";
+    G4Exception("RunAction::BeginOfRunAction()",
+      "MyCode0018", JustWarning, msg);
+  }
+
+  G4AccumulableManager::Instance()->Reset();
+  fTimer.Start();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void RunAction::EndOfRunAction(const G4Run* /*run*/)
+void RunAction::EndOfRunAction(const G4Run* run)
 {
+  fTimer.Stop();
+  fHistograms.Flush();
+  G4AccumulableManager::Instance()->Merge();
+
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+  // throughput of the whole run, the master times the workers
+  if ( IsMaster() && run->GetNumberOfEvent() > 0 ) {
+    G4double seconds = fTimer.GetRealElapsed();
+    G4long nofSteps = fNofSteps.GetValue();
+    G4cout << G4endl
+           << "---> Run " << run->GetRunID() << ": " << run->GetNumberOfEvent()
+           << " events, " << nofSteps << " steps, "
+           << detector->GetNofLayers() << " layers in " << seconds << " s";
+    if ( seconds > 0. ) {
+      G4cout << ": " << run->GetNumberOfEvent()/seconds << " events/s, "
+             << nofSteps/seconds << " steps/s";
+    }
+    G4cout << G4endl;
+  }
+
   // print histogram statistics
   //
   auto analysisManager = G4AnalysisManager::Instance();
+  for (std::size_t plane = 0; plane < fFluxFirstIds.size(); ++plane) {
+    if ( ! IsMaster() || run->GetNumberOfEvent() == 0 ) break;
+    if ( plane == 0 ) {
+      G4cout << "---> Flux into the absorber (entries, mean energy in GeV):" << G4endl;
+    }
+    else {
+      G4cout << "---> Flux at the scoring plane "
+             << fScoringPlanes->GetPlane(plane).name
+             << " (entries, mean energy in GeV):" << G4endl;
+    }
+    for (G4int ih = 1; ih <= 28; ++ih) {
+      auto h1 = analysisManager->GetH1(fFluxFirstIds[plane] + ih - 1);
+      if ( ! h1 || h1->entries() == 0 ) continue;
+      G4cout << "  h" << std::setw(2) << std::left << ih << std::right
+             << std::setw(10) << h1->entries() << std::setw(12) << h1->mean()
+             << "  " << kFluxTitles[ih] << G4endl;
+    }
+  }
+
+  // emulsion hits aggregated per track and film, all threads
+  if ( IsMaster() && fNofHitSteps.GetValue() > fNofHits.GetValue() ) {
+    G4long nofHits = fNofHits.GetValue();
+    G4long nofSteps = fNofHitSteps.GetValue();
+    G4cout << "---> Emulsion hits: " << nofHits << " hits from " << nofSteps
+           << " recorded steps, reduction " << G4double(nofSteps)/nofHits
+           << G4endl;
+  }
+
+  // secondaries killed in the rock, all threads
+  if ( IsMaster() && fRangeKills.GetNofRejected() > 0 ) {
+    G4cout << "---> Range rejection in the rock (killed / charged secondaries,"
+           << " killed energy in GeV):" << G4endl;
+    fRangeKills.Print();
+  }
+
+  // step profile of all threads
+  if ( IsMaster() && fProfileSteps && run->GetNumberOfEvent() > 0 ) {
+    fStepProfiler.Print(fProfileRows);
+    if ( ! fStepProfiler.Write(fProfileFile) ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot write the step profile " << fProfileFile << ".";
+      G4Exception("RunAction::EndOfRunAction()",
+        "MyCode0017", JustWarning, msg);
+    }
+  }
+
+  // rock tables of all threads
+  if ( IsMaster() && fRockCalibration && run->GetNumberOfEvent() > 0 ) {
+    const auto& fileName = detector->GetRockTablesFile();
+    if ( fRockTables.Write(fileName) ) {
+      G4cout << "---> Rock tables of " << fRockTables.GetNofMuons()
+             << " muons written to " << fileName << G4endl;
+    }
+    else {
+      G4ExceptionDescription msg;
+      msg << "Cannot write the rock tables " << fileName << ".";
+      G4Exception("RunAction::EndOfRunAction()",
+        "MyCode0022", JustWarning, msg);
+    }
+  }
+
+  if ( IsMaster() && detector->GetValidateRock() && run->GetNumberOfEvent() > 0 ) {
+    ValidateRock(run, detector->GetRockMode() == DetectorConstruction::kRockFast);
+  }
+
+  // string table of the process identifiers, once per output file
+  if ( IsMaster() && fProcessNtupleId >= 0 ) processRegistry.FillNtuple(fProcessNtupleId);
 
   // save histograms & ntuple
   //
@@ -248,3 +406,62 @@ void RunAction::EndOfRunAction(const G4Run* /*run*/)
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void RunAction::ValidateRock(const G4Run* run, G4bool fast)
+{
+  auto analysisManager = G4AnalysisManager::Instance();
+  G4double nofEvents = run->GetNumberOfEvent();
+
+  // a full simulation run becomes the reference
+  if ( ! fast ) {
+    fFluxReference.assign(29, std::vector<G4double>());
+    fFluxVariance.assign(29, std::vector<G4double>());
+    for (G4int ih = 1; ih <= 28; ++ih) {
+      auto h1 = analysisManager->GetH1(ih);
+      if ( ! h1 ) continue;
+      for (unsigned int ibin = 0; ibin < h1->axis().bins(); ++ibin) {
+        G4double error = h1->bin_error(ibin)/nofEvents;
+        fFluxReference[ih].push_back(h1->bin_height(ibin)/nofEvents);
+        fFluxVariance[ih].push_back(error*error);
+      }
+    }
+    G4cout << "---> Rock validation: flux of run " << run->GetRunID()
+           << " kept as the full simulation reference" << G4endl;
+    return;
+  }
+
+  if ( fFluxReference.empty() ) {
+    G4ExceptionDescription msg;
+    msg << "No full simulation run to validate the fast rock transport against.";
+    G4Exception("RunAction::ValidateRock()",
+      "MyCode0023", JustWarning, msg);
+    return;
+  }
+
+  G4cout << "---> Rock validation, fast vs full simulation flux per event:" << G4endl;
+  for (G4int ih = 1; ih <= 28; ++ih) {
+    auto h1 = analysisManager->GetH1(ih);
+    if ( ! h1 || fFluxReference[ih].size() != h1->axis().bins() ) continue;
+    G4double fastFlux = 0., fullFlux = 0., chi2 = 0.;
+    G4int ndf = 0;
+    for (unsigned int ibin = 0; ibin < h1->axis().bins(); ++ibin) {
+      G4double height = h1->bin_height(ibin)/nofEvents;
+      G4double error = h1->bin_error(ibin)/nofEvents;
+      G4double variance = error*error + fFluxVariance[ih][ibin];
+      fastFlux += height;
+      fullFlux += fFluxReference[ih][ibin];
+      if ( variance > 0. ) {
+        G4double difference = height - fFluxReference[ih][ibin];
+        chi2 += difference*difference/variance;
+        ++ndf;
+      }
+    }
+    if ( ndf == 0 ) continue;
+    G4cout << "  h" << std::setw(2) << std::left << ih << std::right
+           << std::setw(12) << fastFlux << std::setw(12) << fullFlux
+           << "  chi2/ndf " << std::setw(8) << chi2/ndf
+           << "  " << h1->title() << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ScoringMessenger.cc
+/// \brief Implementation of the ScoringMessenger class
+
+#include "ScoringMessenger.hh"
+#include "ScoringPlanes.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringMessenger::ScoringMessenger(ScoringPlanes* planes)
+ : G4UImessenger(),
+   fPlanes(planes),
+   fScoringDir(nullptr),
+   fAddPlaneCmd(nullptr),
+   fListCmd(nullptr)
+{
+  fScoringDir = new G4UIdirectory("/FASERnu/scoring/");
+  fScoringDir->SetGuidance("Flux scoring planes");
+
+  fAddPlaneCmd = new G4UIcommand("/FASERnu/scoring/addPlane", this);
+  fAddPlaneCmd->SetGuidance("Add a scoring plane: the boundary crossed from the first");
+  fAddPlaneCmd->SetGuidance("logical volume into the second, e.g. Rock Station for the");
+  fAddPlaneCmd->SetGuidance("rock exit (its slanted face borders the Station, not the Gap) or");
+  fAddPlaneCmd->SetGuidance("EmulsionLV World for the back face. With copyNo, only");
+  fAddPlaneCmd->SetGuidance("in that copy of the mother of the second volume, e.g. the");
+  fAddPlaneCmd->SetGuidance("layer for AbsoLV. Its histograms are booked at the next run.");
+  auto nameParam = new G4UIparameter("name", 's', false);
+  fAddPlaneCmd->SetParameter(nameParam);
+  auto preParam = new G4UIparameter("preVolume", 's', false);
+  fAddPlaneCmd->SetParameter(preParam);
+  auto postParam = new G4UIparameter("postVolume", 's', false);
+  fAddPlaneCmd->SetParameter(postParam);
+  auto copyParam = new G4UIparameter("copyNo", 'i', true);
+  copyParam->SetDefaultValue(-1);
+  copyParam->SetParameterRange("copyNo>=-1");
+  fAddPlaneCmd->SetParameter(copyParam);
+  fAddPlaneCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAddPlaneCmd->SetToBeBroadcasted(false);
+
+  fListCmd = new G4UIcmdWithoutParameter("/FASERnu/scoring/listPlanes", this);
+  fListCmd->SetGuidance("List the scoring planes.");
+  fListCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fListCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringMessenger::~ScoringMessenger()
+{
+  delete fAddPlaneCmd;
+  delete fListCmd;
+  delete fScoringDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScoringMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fAddPlaneCmd ) {
+    std::istringstream is(newValue);
+    G4String name, preVolume, postVolume;
+    G4int copyNo;
+    is >> name >> preVolume >> postVolume >> copyNo;
+    fPlanes->AddPlane(name, preVolume, postVolume, copyNo);
+  }
+  else if ( command == fListCmd ) {
+    fPlanes->List();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
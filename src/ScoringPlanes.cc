@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file ScoringPlanes.cc
+/// \brief Implementation of the ScoringPlanes class
+
+#include "ScoringPlanes.hh"
+#include "ScoringMessenger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringPlanes::ScoringPlanes()
+ : fMessenger(nullptr),
+   fPlanes()
+{
+  fMessenger = new ScoringMessenger(this);
+  AddPlane("absorber", "Gap", "AbsoLV");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+ScoringPlanes::~ScoringPlanes()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool ScoringPlanes::AddPlane(const G4String& name, const G4String& preVolume,
+                               const G4String& postVolume, G4int copyNo)
+{
+  for (const auto& plane : fPlanes) {
+    if ( plane.name != name ) continue;
+    G4ExceptionDescription msg;
+    msg << "The scoring plane " << name << " is already defined.";
+    G4Exception("ScoringPlanes::AddPlane()",
+      "MyCode0019", JustWarning, msg);
+    return false;
+  }
+  fPlanes.push_back({ name, preVolume, postVolume, copyNo });
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void ScoringPlanes::List() const
+{
+  G4cout << "---> " << fPlanes.size() << " scoring planes:" << G4endl;
+  for (const auto& plane : fPlanes) {
+    G4cout << "  " << plane.name << ": " << plane.preVolume << " -> "
+           << plane.postVolume;
+    if ( plane.copyNo >= 0 ) G4cout << " (copy " << plane.copyNo << ")";
+    G4cout << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,701 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceManager.cc
+/// \brief Implementation of the SourceManager class
+
+#include "SourceManager.hh"
+#include "SourceMessenger.hh"
+#include "HistogramSampler.hh"
+#include "BeamProfile.hh"
+#include "PrimaryStream.hh"
+#include "NuEventFile.hh"
+#include "PhaseSpaceFile.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4MuonMinus.hh"
+#include "Randomize.hh"
+#include "CLHEP/Evaluator/Evaluator.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+namespace {
+  std::vector<G4double> MuonSpectrumEdges()
+  {
+    std::vector<G4double> edges(1, 1.);
+    for (G4int i = 1; i <= 80; ++i) edges.push_back(50.*i);
+    return edges;
+  }
+}
+
+const HistogramSampler& SourceManager::GetDefaultMuonSpectrum()
+{
+  // mu- flux in 80 bins of 50 GeV from 1 to 4000 GeV; the first bin starts
+  // at 1 GeV. Built on first use and shared read-only by all threads.
+  static const G4double prob[80] = {
+    2.26737490143638E-13, 1.50857611716220E-13, 9.39261858919731E-14, 5.84739207638017E-14,
+    3.24571040230013E-14, 2.21104873511029E-14, 1.74440788666807E-14, 1.13615038968873E-14,
+    1.91376476103987E-14, 1.15572681715077E-14, 7.08157341925533E-15, 5.76416620948928E-15,
+    7.81623154711213E-15, 6.56754136726407E-15, 9.16825328611326E-15, 9.76938614058058E-15,
+    9.18127643556841E-15, 1.33602764458908E-14, 1.17961528918552E-14, 1.60210373809235E-14,
+    1.87954543243886E-14, 2.09410212445005E-14, 1.88130671961507E-14, 1.39192548034658E-14,
+    1.14311556205024E-14, 1.30576528682980E-14, 7.99847015869422E-15, 8.28721827849399E-15,
+    8.20053542430517E-15, 8.50771102461677E-15, 5.55066657512325E-15, 6.32841540658163E-15,
+    3.65932255258140E-15, 4.73664423730078E-15, 2.87956818442589E-15, 2.38836106830032E-15,
+    3.91517917503873E-15, 2.14509513316961E-15, 2.12635229162121E-15, 2.12444480825151E-15,
+    1.55989332342560E-15, 1.66292857492464E-15, 1.62162209852412E-15, 2.51204734702591E-15,
+    2.98771625146124E-15, 1.98064518639804E-15, 1.30185775911172E-15, 1.06588489637830E-15,
+    1.30072623716252E-15, 1.95825349026024E-15, 1.82974778894870E-15, 1.75743260276838E-15,
+    7.85581568133859E-16, 8.91558493721251E-16, 4.99882857190907E-16, 5.11922992775425E-16,
+    5.82075402896300E-16, 5.63767765090528E-16, 1.30568419050939E-15, 3.48866039521030E-16,
+    1.28705004775493E-15, 3.03361773496548E-16, 1.55472908916981E-16, 1.50737952570158E-16,
+    2.27297875437635E-16, 1.42200831326507E-16, 7.58404433741371E-17, 1.19773883004941E-16,
+    2.84401662653014E-17, 6.06723546993097E-17, 1.89601108435342E-17, 1.32720775904740E-17,
+    1.89601108435342E-17, 5.68803325306028E-17, 0, 1.89601108435342E-17,
+    3.79202216870685E-17, 1.89601108435342E-17, 1.89601108435342E-17, 0
+  };
+  static const HistogramSampler sampler(MuonSpectrumEdges(),
+                                        std::vector<G4double>(prob, prob+80));
+  return sampler;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceManager::SourceManager()
+ : fSourceSampler(nullptr),
+   fReplay(nullptr),
+   fNuEvents(nullptr),
+   fPhaseSpaceOutput(nullptr),
+   fPhaseSpace(nullptr),
+   fMessenger(nullptr)
+{
+  fDefaultSource.fileName = "built-in";
+  fDefaultSource.particle = G4MuonMinus::Definition();
+  fDefaultSource.spectrum = &GetDefaultMuonSpectrum();
+  fDefaultSource.profile  = kFlat;
+  fDefaultSource.beamProfile = nullptr;
+  fDefaultSource.weight   = fDefaultSource.spectrum->GetIntegral();
+  fDefaultSource.biased   = nullptr;
+
+  fMessenger = new SourceMessenger(this);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceManager::~SourceManager()
+{
+  Clear();
+  CloseReplay();
+  CloseNuEvents();
+  StopRecording();
+  ClosePhaseSpace();
+  ClearBias(fDefaultSource);
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::ReadSpectrum(const G4String& fileName,
+                                   std::vector<G4double>& binEdges,
+                                   std::vector<G4double>& binWeights)
+{
+  std::ifstream input(fileName);
+  if ( ! input.is_open() ) return false;
+
+  // bin centres and fluxes, '#' starts a comment
+  std::vector<G4double> centres;
+  binWeights.clear();
+  std::string line;
+  while ( std::getline(input, line) ) {
+    auto hash = line.find('#');
+    if ( hash != std::string::npos ) line.erase(hash);
+    std::istringstream fields(line);
+    G4double centre, flux;
+    if ( ! ( fields >> centre >> flux ) ) continue;
+    centres.push_back(centre);
+    binWeights.push_back(flux);
+  }
+  if ( centres.size() < 2 ) return false;
+
+  // edges half way between the centres, outer bins symmetric
+  auto nofBins = centres.size();
+  binEdges.resize(nofBins+1);
+  binEdges[0] = centres[0] - 0.5*(centres[1]-centres[0]);
+  for (std::size_t i = 1; i < nofBins; ++i) {
+    binEdges[i] = 0.5*(centres[i-1]+centres[i]);
+  }
+  binEdges[nofBins] = centres[nofBins-1] + 0.5*(centres[nofBins-1]-centres[nofBins-2]);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ParticleDefinition* SourceManager::FindParticle(const G4String& particleName)
+{
+  // PDG code or Geant4 particle name
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  std::istringstream is(particleName);
+  G4int pdg = 0;
+  if ( ( is >> pdg ) && is.eof() ) return particleTable->FindParticle(pdg);
+  return particleTable->FindParticle(particleName);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::AddSpectrum(const G4String& fileName,
+                                  const G4String& particleName)
+{
+  auto particle = FindParticle(particleName);
+  if ( ! particle ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown particle " << particleName << ", spectrum "
+        << fileName << " ignored.";
+    G4Exception("SourceManager::AddSpectrum()",
+      "MyCode0006", JustWarning, msg);
+    return false;
+  }
+
+  // weighted by the integrated flux of the file
+  return InsertSource(particle, -1., fileName, kFlat);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::AddSource(const G4String& particleName, G4double fraction,
+                                const G4String& spectrum, const G4String& profile)
+{
+  auto particle = FindParticle(particleName);
+  if ( ! particle || ! ( fraction > 0. ) ) {
+    G4ExceptionDescription msg;
+    msg << "Invalid source " << particleName << " " << fraction << " "
+        << spectrum << " " << profile << ", ignored." << G4endl
+        << "Expected a known PDG code or particle name and a positive fraction.";
+    G4Exception("SourceManager::AddSource()",
+      "MyCode0024", JustWarning, msg);
+    return false;
+  }
+
+  if ( profile == "flat" ) return InsertSource(particle, fraction, spectrum, kFlat);
+  if ( profile == "pencil" ) return InsertSource(particle, fraction, spectrum, kPencil);
+
+  // anything else is a beam profile map file
+  auto beamProfile = GetBeamProfile(profile);
+  if ( ! beamProfile ) return false;
+  return InsertSource(particle, fraction, spectrum, kMap, beamProfile);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const BeamProfile* SourceManager::GetBeamProfile(const G4String& fileName)
+{
+  // each map is read once and shared by the sources using it
+  auto it = fBeamProfiles.find(fileName);
+  if ( it != fBeamProfiles.end() ) return it->second;
+
+  auto beamProfile = new BeamProfile();
+  if ( ! beamProfile->Read(fileName) ) {
+    delete beamProfile;
+    G4ExceptionDescription msg;
+    msg << "Cannot read a beam profile map from " << fileName << "." << G4endl
+        << "Expected x and y axis lines \"x nbins min max\", an optional e axis"
+        << " and one non-negative weight per cell.";
+    G4Exception("SourceManager::GetBeamProfile()",
+      "MyCode0011", JustWarning, msg);
+    return nullptr;
+  }
+  fBeamProfiles[fileName] = beamProfile;
+  return beamProfile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::ReadSources(const G4String& fileName)
+{
+  std::ifstream input(fileName);
+  if ( ! input.is_open() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open the source table " << fileName << ".";
+    G4Exception("SourceManager::ReadSources()",
+      "MyCode0025", JustWarning, msg);
+    return false;
+  }
+
+  // particle fraction [spectrum] [profile], '#' starts a comment
+  G4bool valid = true;
+  std::string line;
+  while ( std::getline(input, line) ) {
+    auto hash = line.find('#');
+    if ( hash != std::string::npos ) line.erase(hash);
+    std::istringstream fields(line);
+    G4String particleName, spectrum("default"), profile("flat");
+    G4double fraction = 0.;
+    if ( ! ( fields >> particleName ) ) continue;
+    fields >> fraction >> spectrum >> profile;
+    valid = AddSource(particleName, fraction, spectrum, profile) && valid;
+  }
+  return valid;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::InsertSource(G4ParticleDefinition* particle, G4double weight,
+                                   const G4String& spectrum, Profile profile,
+                                   const BeamProfile* beamProfile)
+{
+  // the built-in muon spectrum is shared, files are read once here
+  const HistogramSampler* sampler = &GetDefaultMuonSpectrum();
+  if ( spectrum != "default" ) {
+    std::vector<G4double> binEdges, binWeights;
+    if ( ! ReadSpectrum(spectrum, binEdges, binWeights) ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot read a spectrum of at least two bins from " << spectrum
+          << ", ignored.";
+      G4Exception("SourceManager::InsertSource()",
+        "MyCode0026", JustWarning, msg);
+      return false;
+    }
+    sampler = new HistogramSampler(binEdges, binWeights);
+  }
+
+  Source source;
+  source.fileName = ( spectrum == "default" ) ? G4String("built-in") : spectrum;
+  source.particle = particle;
+  source.spectrum = sampler;
+  source.profile  = profile;
+  source.beamProfile = beamProfile;
+  source.weight   = ( weight > 0. ) ? weight : sampler->GetIntegral();
+  source.biased   = nullptr;
+  if ( fBiasExpression.size() && ! BuildBias(source) ) {
+    G4ExceptionDescription msg;
+    msg << "Energy bias \"" << fBiasExpression << "\" not positive over "
+        << source.fileName << ", this source is sampled unbiased.";
+    G4Exception("SourceManager::InsertSource()",
+      "MyCode0009", JustWarning, msg);
+  }
+  fSources.push_back(source);
+
+  BuildSourceSampler();
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::Clear()
+{
+  for (auto& source : fSources) {
+    ClearBias(source);
+    if ( source.spectrum != &GetDefaultMuonSpectrum() ) delete source.spectrum;
+  }
+  fSources.clear();
+  for (auto& entry : fBeamProfiles) delete entry.second;
+  fBeamProfiles.clear();
+  delete fSourceSampler;
+  fSourceSampler = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::BuildSourceSampler()
+{
+  delete fSourceSampler;
+  fSourceSampler = nullptr;
+
+  std::vector<G4double> edges(1, 0.), weights;
+  for (const auto& source : fSources) {
+    edges.push_back(edges.size());
+    weights.push_back(source.weight);
+  }
+  fSourceSampler = new HistogramSampler(edges, weights);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ParticleDefinition* SourceManager::Sample(PrimaryRecord& primary) const
+{
+  // source picked by its weight, mu- with the default spectrum when none
+  const Source* source = &fDefaultSource;
+  if ( fSources.size() == 1 ) source = &fSources[0];
+  else if ( fSources.size() > 1 ) source = &fSources[fSourceSampler->ShootBin()];
+
+  // energy in GeV, from a joint beam profile map, else from the biased
+  // spectrum with its bin weight if any
+  G4bool jointEnergy = source->profile == kMap && source->beamProfile->HasEnergy();
+  if ( jointEnergy ) {
+    primary.weight = 1.;
+  }
+  else if ( source->biased ) {
+    G4int bin = source->biased->ShootBin();
+    primary.energy = source->biased->SampleInBin(bin, G4UniformRand());
+    primary.weight = source->binWeights[bin];
+  }
+  else {
+    primary.energy = source->spectrum->Shoot();
+    primary.weight = 1.;
+  }
+  primary.pdg = source->particle->GetPDGEncoding();
+
+  // transverse position in cm, along the beam axis
+  if ( source->profile == kFlat ) {
+    primary.x = G4RandFlat::shoot(-7.50,7.50);
+    primary.y = G4RandFlat::shoot(-6.25,6.25);
+  }
+  else if ( source->profile == kMap ) {
+    G4double x, y, energy = 0.;
+    source->beamProfile->Shoot(x, y, energy);
+    primary.x = x;
+    primary.y = y;
+    if ( jointEnergy ) primary.energy = energy;
+  }
+  else {
+    primary.x = 0.;
+    primary.y = 0.;
+  }
+  primary.dx = 0.;
+  primary.dy = 0.;
+  primary.dz = 1.;
+
+  return source->particle;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::SetEnergyBias(const G4String& expression)
+{
+  G4String previous = fBiasExpression;
+  fBiasExpression = ( expression == "none" ) ? "" : expression;
+  if ( RebuildBias() ) return true;
+
+  G4ExceptionDescription msg;
+  msg << "Invalid energy bias \"" << fBiasExpression << "\": it must evaluate"
+      << " to a positive number at every populated bin centre E (GeV)."
+      << G4endl << "Bias left unchanged.";
+  G4Exception("SourceManager::SetEnergyBias()",
+    "MyCode0029", JustWarning, msg);
+  fBiasExpression = previous;
+  RebuildBias();
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::RebuildBias()
+{
+  G4bool valid = true;
+  std::vector<Source*> sources(1, &fDefaultSource);
+  for (auto& source : fSources) sources.push_back(&source);
+  for (auto source : sources) {
+    if ( fBiasExpression.empty() ) ClearBias(*source);
+    else valid = BuildBias(*source) && valid;
+  }
+  return valid;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::BuildBias(Source& source) const
+{
+  ClearBias(source);
+
+  HepTool::Evaluator evaluator;
+  evaluator.setStdMath();
+
+  // biased bin probabilities q = p*b/sum(p*b), event weight p/q = sum(p*b)/b
+  const auto spectrum = source.spectrum;
+  G4int nofBins = spectrum->GetNofBins();
+  std::vector<G4double> edges(nofBins+1), biased(nofBins), bias(nofBins);
+  G4double norm = 0.;
+  for (G4int i = 0; i < nofBins; ++i) {
+    edges[i] = spectrum->GetLowEdge(i);
+    evaluator.setVariable("E", 0.5*(spectrum->GetLowEdge(i)+spectrum->GetHighEdge(i)));
+    bias[i] = evaluator.evaluate(fBiasExpression.c_str());
+    if ( evaluator.status() != HepTool::Evaluator::OK ) return false;
+    G4double prob = spectrum->GetBinProbability(i);
+    if ( prob > 0. && ! ( bias[i] > 0. ) ) return false;
+    biased[i] = ( prob > 0. ) ? prob*bias[i] : 0.;
+    norm += biased[i];
+  }
+  edges[nofBins] = spectrum->GetHighEdge(nofBins-1);
+
+  source.biased = new HistogramSampler(edges, biased, spectrum->GetInterpolation());
+  source.binWeights.resize(nofBins);
+  for (G4int i = 0; i < nofBins; ++i) {
+    source.binWeights[i] = ( biased[i] > 0. ) ? norm/bias[i] : 0.;
+  }
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::ClearBias(Source& source) const
+{
+  delete source.biased;
+  source.biased = nullptr;
+  source.binWeights.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::WritePrimaries(const G4String& fileName,
+                                     G4int nofPrimaries) const
+{
+  PrimaryStreamWriter writer;
+  if ( ! writer.Open(fileName) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open " << fileName << " for writing.";
+    G4Exception("SourceManager::WritePrimaries()",
+      "MyCode0008", JustWarning, msg);
+    return false;
+  }
+
+  PrimaryRecord primary;
+  for (G4int i = 0; i < nofPrimaries; ++i) {
+    Sample(primary);
+    writer.Write(primary);
+  }
+  writer.Close();
+
+  G4cout << "---> " << nofPrimaries << " primaries written to "
+         << fileName << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::OpenReplay(const G4String& fileName)
+{
+  CloseReplay();
+
+  auto replay = new PrimaryStreamReader();
+  if ( ! replay->Open(fileName) || replay->GetNofRecords() == 0 ) {
+    delete replay;
+    G4ExceptionDescription msg;
+    msg << "Cannot map " << fileName << " as a non-empty primary stream,"
+        << " primaries are sampled from the sources.";
+    G4Exception("SourceManager::OpenReplay()",
+      "MyCode0027", JustWarning, msg);
+    return false;
+  }
+  fReplay = replay;
+
+  G4cout << "---> Replaying " << fReplay->GetNofRecords()
+         << " primaries from " << fileName << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::CloseReplay()
+{
+  delete fReplay;
+  fReplay = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::OpenNuEvents(const G4String& fileName)
+{
+  CloseNuEvents();
+
+  auto nuEvents = new NuEventReader();
+  if ( ! nuEvents->Open(fileName) ) {
+    delete nuEvents;
+    G4ExceptionDescription msg;
+    msg << "Cannot open the neutrino event file " << fileName << "," << G4endl
+        << "it must be HepMC2 ASCII (IO_GenEvent) or the binary format.";
+    G4Exception("SourceManager::OpenNuEvents()",
+      "MyCode0010", JustWarning, msg);
+    return false;
+  }
+  fNuEvents = nuEvents;
+
+  G4cout << "---> Reading neutrino interactions from " << fileName
+         << ( fNuEvents->IsBinary() ? " (binary)" : " (HepMC)" ) << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::CloseNuEvents()
+{
+  delete fNuEvents;
+  fNuEvents = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::RecordPhaseSpace(const G4String& fileName,
+                                       G4bool killAtBoundary)
+{
+  StopRecording();
+
+  auto output = new PhaseSpaceWriter();
+  if ( ! output->Open(fileName, killAtBoundary) ) {
+    delete output;
+    G4ExceptionDescription msg;
+    msg << "Cannot open the phase space file " << fileName << " for writing.";
+    G4Exception("SourceManager::RecordPhaseSpace()",
+      "MyCode0015", JustWarning, msg);
+    return false;
+  }
+  fPhaseSpaceOutput = output;
+
+  G4cout << "---> Recording the absorber entry phase space to " << fileName
+         << ( killAtBoundary ? ", particles stopped there" : "" ) << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::StopRecording()
+{
+  // closing writes the record and event counts in the header
+  if ( fPhaseSpaceOutput ) {
+    G4cout << "---> " << fPhaseSpaceOutput->GetNofRecords() << " particles of "
+           << fPhaseSpaceOutput->GetNofEvents() << " events recorded to "
+           << fPhaseSpaceOutput->GetFileName() << G4endl;
+  }
+  delete fPhaseSpaceOutput;
+  fPhaseSpaceOutput = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::OpenPhaseSpace(const G4String& fileName)
+{
+  ClosePhaseSpace();
+
+  auto phaseSpace = new PhaseSpaceReader();
+  if ( ! phaseSpace->Open(fileName) || phaseSpace->GetNofEvents() == 0 ) {
+    delete phaseSpace;
+    G4ExceptionDescription msg;
+    msg << "Cannot map " << fileName << " as a non-empty phase space file.";
+    G4Exception("SourceManager::OpenPhaseSpace()",
+      "MyCode0033", JustWarning, msg);
+    return false;
+  }
+  fPhaseSpace = phaseSpace;
+
+  G4cout << "---> Replaying " << fPhaseSpace->GetNofRecords() << " particles of "
+         << fPhaseSpace->GetNofEvents() << " events from " << fileName
+         << " (" << fPhaseSpace->GetNofGeneratedEvents()
+         << " stage-1 events, to normalise the flux)" << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::ClosePhaseSpace()
+{
+  delete fPhaseSpace;
+  fPhaseSpace = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool SourceManager::ConvertNuEvents(const G4String& inputName,
+                                      const G4String& outputName)
+{
+  NuEventReader reader;
+  NuEventWriter writer;
+  if ( ! reader.Open(inputName) || ! writer.Open(outputName) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot convert " << inputName << " to " << outputName << ".";
+    G4Exception("SourceManager::ConvertNuEvents()",
+      "MyCode0030", JustWarning, msg);
+    return false;
+  }
+
+  NuEvent event;
+  while ( reader.Next(event) ) writer.Write(event);
+  writer.Close();
+
+  G4cout << "---> " << writer.GetNofEvents() << " neutrino interactions written to "
+         << outputName << G4endl;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceManager::List() const
+{
+  G4double total = 0.;
+  for (const auto& source : fSources) total += source.weight;
+
+  if ( fNuEvents ) {
+    G4cout << G4endl << "---> Neutrino interactions from "
+           << fNuEvents->GetFileName() << ", the sources below are not used"
+           << G4endl;
+  }
+
+  if ( fPhaseSpace ) {
+    G4cout << G4endl << "---> Replaying the phase space " << fPhaseSpace->GetFileName()
+           << ", the sources below are not used" << G4endl;
+  }
+
+  if ( fPhaseSpaceOutput ) {
+    G4cout << G4endl << "---> Recording the phase space to "
+           << fPhaseSpaceOutput->GetFileName() << G4endl;
+  }
+
+  if ( fReplay ) {
+    G4cout << G4endl << "---> Replaying " << fReplay->GetNofRecords()
+           << " primaries from " << fReplay->GetFileName()
+           << ", the sources below are not used" << G4endl;
+  }
+
+  if ( fBiasExpression.size() ) {
+    G4cout << G4endl << "---> Energy biased by b(E) = " << fBiasExpression
+           << ", events are weighted" << G4endl;
+  }
+
+  G4cout << G4endl << "---> " << fSources.size() << " primary source(s)";
+  if ( fSources.empty() ) G4cout << ", using the default mu- spectrum";
+  G4cout << G4endl;
+  for (const auto& source : fSources) {
+    G4cout << "  " << std::setw(8) << source.particle->GetParticleName();
+    if ( source.profile == kMap && source.beamProfile->HasEnergy() ) {
+      G4cout << ": (E, x, y) from " << source.beamProfile->GetFileName();
+    }
+    else {
+      G4cout << " from " << source.fileName
+             << ": " << source.spectrum->GetNofBins() << " bins in ["
+             << source.spectrum->GetLowEdge(0) << ", "
+             << source.spectrum->GetHighEdge(source.spectrum->GetNofBins()-1)
+             << "] GeV, ";
+      if ( source.profile == kFlat ) G4cout << "flat";
+      else if ( source.profile == kPencil ) G4cout << "pencil";
+      else G4cout << "(x, y) from " << source.beamProfile->GetFileName();
+    }
+    G4cout << ", fraction " << source.weight/total << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,296 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file SourceMessenger.cc
+/// \brief Implementation of the SourceMessenger class
+
+#include "SourceMessenger.hh"
+#include "SourceManager.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAString.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceMessenger::SourceMessenger(SourceManager* manager)
+ : G4UImessenger(),
+   fManager(manager),
+   fGunDir(nullptr),
+   fAddSpectrumCmd(nullptr),
+   fAddSourceCmd(nullptr),
+   fReadSourcesCmd(nullptr),
+   fClearCmd(nullptr),
+   fListCmd(nullptr),
+   fWriteCmd(nullptr),
+   fReplayCmd(nullptr),
+   fStopReplayCmd(nullptr),
+   fBiasCmd(nullptr),
+   fNuEventsCmd(nullptr),
+   fStopNuEventsCmd(nullptr),
+   fConvertNuEventsCmd(nullptr),
+   fRecordPhaseSpaceCmd(nullptr),
+   fStopRecordingCmd(nullptr),
+   fPhaseSpaceCmd(nullptr),
+   fStopPhaseSpaceCmd(nullptr)
+{
+  fGunDir = new G4UIdirectory("/FASERnu/gun/");
+  fGunDir->SetGuidance("Primary source control");
+
+  fAddSpectrumCmd = new G4UIcommand("/FASERnu/gun/addSpectrum", this);
+  fAddSpectrumCmd->SetGuidance("Add a source: particle with an energy spectrum.");
+  fAddSpectrumCmd->SetGuidance("The file has two columns, bin centre in GeV and flux.");
+  fAddSpectrumCmd->SetGuidance("Sources are picked by their integrated flux.");
+  auto fileParam = new G4UIparameter("fileName", 's', false);
+  fAddSpectrumCmd->SetParameter(fileParam);
+  auto particleParam = new G4UIparameter("particle", 's', true);
+  particleParam->SetDefaultValue("mu-");
+  fAddSpectrumCmd->SetParameter(particleParam);
+  fAddSpectrumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAddSpectrumCmd->SetToBeBroadcasted(false);
+
+  fAddSourceCmd = new G4UIcommand("/FASERnu/gun/addSource", this);
+  fAddSourceCmd->SetGuidance("Add a species to the source mixture.");
+  fAddSourceCmd->SetGuidance("The particle is a PDG code or a name, the fraction a relative");
+  fAddSourceCmd->SetGuidance("weight, the spectrum a file as for addSpectrum or default for");
+  fAddSourceCmd->SetGuidance("the built-in muon spectrum, the profile flat, pencil or a");
+  fAddSourceCmd->SetGuidance("beam profile map file in x, y or E, x, y (see BeamProfile.hh).");
+  fAddSourceCmd->SetGuidance("Do not mix with addSpectrum, which weights by the flux.");
+  auto sourceParticleParam = new G4UIparameter("particle", 's', false);
+  fAddSourceCmd->SetParameter(sourceParticleParam);
+  auto fractionParam = new G4UIparameter("fraction", 'd', false);
+  fractionParam->SetParameterRange("fraction>0.");
+  fAddSourceCmd->SetParameter(fractionParam);
+  auto spectrumParam = new G4UIparameter("spectrum", 's', true);
+  spectrumParam->SetDefaultValue("default");
+  fAddSourceCmd->SetParameter(spectrumParam);
+  auto profileParam = new G4UIparameter("profile", 's', true);
+  profileParam->SetDefaultValue("flat");
+  fAddSourceCmd->SetParameter(profileParam);
+  fAddSourceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fAddSourceCmd->SetToBeBroadcasted(false);
+
+  fReadSourcesCmd = new G4UIcmdWithAString("/FASERnu/gun/readSources", this);
+  fReadSourcesCmd->SetGuidance("Add the species of a mixture table file, one per line:");
+  fReadSourcesCmd->SetGuidance("particle fraction [spectrum] [profile], as for addSource.");
+  fReadSourcesCmd->SetParameterName("fileName", false);
+  fReadSourcesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReadSourcesCmd->SetToBeBroadcasted(false);
+
+  fClearCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/clearSources", this);
+  fClearCmd->SetGuidance("Remove all sources, back to the default mu- spectrum.");
+  fClearCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fClearCmd->SetToBeBroadcasted(false);
+
+  fListCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/listSources", this);
+  fListCmd->SetGuidance("Print the primary sources.");
+  fListCmd->SetToBeBroadcasted(false);
+
+  fWriteCmd = new G4UIcommand("/FASERnu/gun/writePrimaries", this);
+  fWriteCmd->SetGuidance("Sample primaries from the sources into a binary stream file,");
+  fWriteCmd->SetGuidance("without transporting them.");
+  auto writeFileParam = new G4UIparameter("fileName", 's', false);
+  fWriteCmd->SetParameter(writeFileParam);
+  auto nofParam = new G4UIparameter("nofPrimaries", 'i', false);
+  nofParam->SetParameterRange("nofPrimaries>0");
+  fWriteCmd->SetParameter(nofParam);
+  fWriteCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fWriteCmd->SetToBeBroadcasted(false);
+
+  fReplayCmd = new G4UIcmdWithAString("/FASERnu/gun/replayPrimaries", this);
+  fReplayCmd->SetGuidance("Map a primary stream file, event N then uses primary N.");
+  fReplayCmd->SetParameterName("fileName", false);
+  fReplayCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fReplayCmd->SetToBeBroadcasted(false);
+
+  fStopReplayCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/stopReplay", this);
+  fStopReplayCmd->SetGuidance("Unmap the primary stream, back to sampling the sources.");
+  fStopReplayCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStopReplayCmd->SetToBeBroadcasted(false);
+
+  fBiasCmd = new G4UIcmdWithAString("/FASERnu/gun/energyBias", this);
+  fBiasCmd->SetGuidance("Importance sample the energy: bin probabilities are multiplied");
+  fBiasCmd->SetGuidance("by the bias function b(E) of the bin centre E in GeV and each");
+  fBiasCmd->SetGuidance("event is weighted accordingly, e.g. \"pow(E/100,1.5)\".");
+  fBiasCmd->SetGuidance("Quote expressions with blanks; none switches the bias off.");
+  fBiasCmd->SetParameterName("expression", false);
+  fBiasCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fBiasCmd->SetToBeBroadcasted(false);
+
+  fNuEventsCmd = new G4UIcmdWithAString("/FASERnu/gun/nuEvents", this);
+  fNuEventsCmd->SetGuidance("Read neutrino interactions from a HepMC2 ASCII or binary file;");
+  fNuEventsCmd->SetGuidance("each event produces the final state particles of the next one.");
+  fNuEventsCmd->SetParameterName("fileName", false);
+  fNuEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fNuEventsCmd->SetToBeBroadcasted(false);
+
+  fStopNuEventsCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/stopNuEvents", this);
+  fStopNuEventsCmd->SetGuidance("Close the neutrino event file, back to the other sources.");
+  fStopNuEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStopNuEventsCmd->SetToBeBroadcasted(false);
+
+  fConvertNuEventsCmd = new G4UIcommand("/FASERnu/gun/convertNuEvents", this);
+  fConvertNuEventsCmd->SetGuidance("Convert a HepMC2 ASCII neutrino event file to the binary format.");
+  auto inputParam = new G4UIparameter("inputName", 's', false);
+  fConvertNuEventsCmd->SetParameter(inputParam);
+  auto outputParam = new G4UIparameter("outputName", 's', false);
+  fConvertNuEventsCmd->SetParameter(outputParam);
+  fConvertNuEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fConvertNuEventsCmd->SetToBeBroadcasted(false);
+
+  fRecordPhaseSpaceCmd = new G4UIcommand("/FASERnu/gun/recordPhaseSpace", this);
+  fRecordPhaseSpaceCmd->SetGuidance("Stage 1: write the particles entering the first absorber");
+  fRecordPhaseSpaceCmd->SetGuidance("from the Gap to a phase space file, with their event and");
+  fRecordPhaseSpaceCmd->SetGuidance("weight; with kill they are not tracked further.");
+  auto recordFileParam = new G4UIparameter("fileName", 's', false);
+  fRecordPhaseSpaceCmd->SetParameter(recordFileParam);
+  auto killParam = new G4UIparameter("kill", 'b', true);
+  killParam->SetDefaultValue(true);
+  fRecordPhaseSpaceCmd->SetParameter(killParam);
+  fRecordPhaseSpaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fRecordPhaseSpaceCmd->SetToBeBroadcasted(false);
+
+  fStopRecordingCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/stopRecording", this);
+  fStopRecordingCmd->SetGuidance("Close the phase space file being recorded.");
+  fStopRecordingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStopRecordingCmd->SetToBeBroadcasted(false);
+
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/FASERnu/gun/phaseSpace", this);
+  fPhaseSpaceCmd->SetGuidance("Stage 2: map a phase space file, event N then replays the");
+  fPhaseSpaceCmd->SetGuidance("particles of its N-th recorded event at the calorimeter face.");
+  fPhaseSpaceCmd->SetParameterName("fileName", false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fPhaseSpaceCmd->SetToBeBroadcasted(false);
+
+  fStopPhaseSpaceCmd = new G4UIcmdWithoutParameter("/FASERnu/gun/stopPhaseSpace", this);
+  fStopPhaseSpaceCmd->SetGuidance("Unmap the phase space file, back to the other sources.");
+  fStopPhaseSpaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+  fStopPhaseSpaceCmd->SetToBeBroadcasted(false);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SourceMessenger::~SourceMessenger()
+{
+  delete fAddSpectrumCmd;
+  delete fAddSourceCmd;
+  delete fReadSourcesCmd;
+  delete fClearCmd;
+  delete fListCmd;
+  delete fWriteCmd;
+  delete fReplayCmd;
+  delete fStopReplayCmd;
+  delete fBiasCmd;
+  delete fNuEventsCmd;
+  delete fStopNuEventsCmd;
+  delete fConvertNuEventsCmd;
+  delete fRecordPhaseSpaceCmd;
+  delete fStopRecordingCmd;
+  delete fPhaseSpaceCmd;
+  delete fStopPhaseSpaceCmd;
+  delete fGunDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SourceMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fAddSpectrumCmd ) {
+    std::istringstream is(newValue);
+    G4String fileName, particleName;
+    is >> fileName >> particleName;
+    fManager->AddSpectrum(fileName, particleName);
+  }
+  else if ( command == fAddSourceCmd ) {
+    std::istringstream is(newValue);
+    G4String particleName, spectrum, profile;
+    G4double fraction = 0.;
+    is >> particleName >> fraction >> spectrum >> profile;
+    fManager->AddSource(particleName, fraction, spectrum, profile);
+  }
+  else if ( command == fReadSourcesCmd ) {
+    fManager->ReadSources(newValue);
+  }
+  else if ( command == fClearCmd ) {
+    fManager->Clear();
+  }
+  else if ( command == fListCmd ) {
+    fManager->List();
+  }
+  else if ( command == fWriteCmd ) {
+    std::istringstream is(newValue);
+    G4String fileName;
+    G4int nofPrimaries = 0;
+    is >> fileName >> nofPrimaries;
+    fManager->WritePrimaries(fileName, nofPrimaries);
+  }
+  else if ( command == fReplayCmd ) {
+    fManager->OpenReplay(newValue);
+  }
+  else if ( command == fStopReplayCmd ) {
+    fManager->CloseReplay();
+  }
+  else if ( command == fBiasCmd ) {
+    G4String expression = newValue;
+    if ( expression.size() > 1 && expression.front() == '"' && expression.back() == '"' ) {
+      expression = expression.substr(1, expression.size()-2);
+    }
+    fManager->SetEnergyBias(expression);
+  }
+  else if ( command == fNuEventsCmd ) {
+    fManager->OpenNuEvents(newValue);
+  }
+  else if ( command == fStopNuEventsCmd ) {
+    fManager->CloseNuEvents();
+  }
+  else if ( command == fConvertNuEventsCmd ) {
+    std::istringstream is(newValue);
+    G4String inputName, outputName;
+    is >> inputName >> outputName;
+    SourceManager::ConvertNuEvents(inputName, outputName);
+  }
+  else if ( command == fRecordPhaseSpaceCmd ) {
+    std::istringstream is(newValue);
+    G4String fileName, kill;
+    is >> fileName >> kill;
+    fManager->RecordPhaseSpace(fileName, G4UIcommand::ConvertToBool(kill));
+  }
+  else if ( command == fStopRecordingCmd ) {
+    fManager->StopRecording();
+  }
+  else if ( command == fPhaseSpaceCmd ) {
+    fManager->OpenPhaseSpace(newValue);
+  }
+  else if ( command == fStopPhaseSpaceCmd ) {
+    fManager->ClosePhaseSpace();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -24,110 +24,83 @@
 // ********************************************************************
 //
 //
-/// \file CalorHit.cc
-/// \brief Implementation of the CalorHit class
+/// \file SpeciesCounter.cc
+/// \brief Implementation of the SpeciesCounter class
 
-#include "CalorHit.hh"
-#include "G4UnitsTable.hh"
-#include "G4VVisManager.hh"
-#include "G4Circle.hh"
-#include "G4Colour.hh"
-#include "G4VisAttributes.hh"
+#include "SpeciesCounter.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4SystemOfUnits.hh"
 
 #include <iomanip>
 
-G4ThreadLocal G4Allocator<CalorHit>* CalorHitAllocator = 0;
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SpeciesCounter::SpeciesCounter(const G4String& name)
+ : G4VAccumulable(name),
+   fCounts()
+{}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorHit::CalorHit()
- : G4VHit(),
-   fCham(-1),
-   fIDZ(-1),
-   fIDZsub(-1),
-   fParticleID(0),
-   fTrackID(0),
-   fParentID(0),
-   fCharge(0),
-   fE1(0),
-   fE2(0),
-   fEdep(0),
-   fLen(0),
-   fPos(0),
-   fMom(0),
-   fProcName("")
+SpeciesCounter::~SpeciesCounter()
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorHit::~CalorHit() {}
+void SpeciesCounter::CountRejected(G4int pdg, G4double energy)
+{
+  auto& counts = fCounts[Key(pdg)];
+  ++counts.nofRejected;
+  counts.rejectedEnergy += energy;
+}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-CalorHit::CalorHit(const CalorHit& right)
-  : G4VHit()
+void SpeciesCounter::Merge(const G4VAccumulable& other)
 {
-  fCham         = right.fCham;
-  fIDZ          = right.fIDZ;
-  fIDZsub       = right.fIDZsub;
-  fParticleID   = right.fParticleID;
-  fTrackID      = right.fTrackID;
-  fParentID     = right.fParentID;
-  fCharge       = right.fCharge;
-  fPos          = right.fPos;
-  fMom          = right.fMom;
-  fE1           = right.fE1;
-  fE2           = right.fE2;
-  fEdep         = right.fEdep;
-  fLen          = right.fLen;
-  fProcName     = right.fProcName;
+  for (const auto& entry : static_cast<const SpeciesCounter&>(other).fCounts) {
+    auto& counts = fCounts[entry.first];
+    counts.nofTracks += entry.second.nofTracks;
+    counts.nofRejected += entry.second.nofRejected;
+    counts.rejectedEnergy += entry.second.rejectedEnergy;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-const CalorHit& CalorHit::operator=(const CalorHit& right)
+void SpeciesCounter::Reset()
 {
-  fCham         = right.fCham;
-  fIDZ          = right.fIDZ;
-  fIDZsub       = right.fIDZsub;
-  fParticleID   = right.fParticleID;
-  fTrackID      = right.fTrackID;
-  fParentID     = right.fParentID;
-  fCharge       = right.fCharge;
-  fPos          = right.fPos;
-  fMom          = right.fMom;
-  fE1           = right.fE1;
-  fE2           = right.fE2;
-  fEdep         = right.fEdep;
-  fLen          = right.fLen;
-  fProcName     = right.fProcName;
-
-  return *this;
+  fCounts.clear();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-G4bool CalorHit::operator==(const CalorHit& right) const
+G4long SpeciesCounter::GetNofRejected() const
 {
-  return ( this == &right ) ? true : false;
+  G4long nofRejected = 0;
+  for (const auto& entry : fCounts) nofRejected += entry.second.nofRejected;
+  return nofRejected;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void CalorHit::Print()
+void SpeciesCounter::Print() const
 {
-  G4cout
-     << "PDGID: "
-     << std::setw(5) <<  fParticleID << " "
-     << "Cham,IDZ,IDZsub,X,Y: "
-     << std::setw(1) <<  fCham << " "
-     << std::setw(3) <<  fIDZ << " "
-     << std::setw(1) <<  fIDZsub << " "
-     << std::setw(6) <<  fPos.x() << " "
-     << std::setw(6) <<  fPos.y()
-     << ", Edep: " 
-     << std::setw(7) << G4BestUnit(fEdep,"Energy")
-     << G4endl;
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  for (const auto& entry : fCounts) {
+    const auto& counts = entry.second;
+    if ( counts.nofRejected == 0 ) continue;
+    auto particle = ( entry.first == kIons ) ? nullptr
+                  : particleTable->FindParticle(entry.first);
+    G4String name = ( entry.first == kIons ) ? G4String("ions")
+                  : particle ? particle->GetParticleName()
+                  : G4String(std::to_string(entry.first));
+    G4cout << "  " << std::setw(12) << std::left << name << std::right
+           << std::setw(12) << counts.nofRejected << " / "
+           << std::setw(12) << counts.nofTracks
+           << std::setw(12) << counts.rejectedEnergy/GeV << G4endl;
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,105 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StackingAction.cc
+/// \brief Implementation of the StackingAction class
+
+#include "StackingAction.hh"
+#include "RunAction.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4Track.hh"
+#include "G4VTouchable.hh"
+#include "G4NavigationHistory.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VSolid.hh"
+#include "G4RunManager.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::StackingAction(RunAction* runAction)
+ : G4UserStackingAction(),
+   fRunAction(runAction),
+   fEmCalculator(),
+   fRangeKill(false),
+   fRangeMargin(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StackingAction::~StackingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StackingAction::PrepareNewEvent()
+{
+  auto detector = static_cast<const DetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fRangeKill = detector->GetRangeKill();
+  fRangeMargin = detector->GetRangeMargin();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ClassificationOfNewTrack
+StackingAction::ClassifyNewTrack(const G4Track* track)
+{
+  if ( ! fRangeKill || track->GetParentID() == 0 ) return fUrgent;
+
+  // secondaries start in the volume of their parent's step end
+  const G4VTouchable* touchable = track->GetTouchable();
+  if ( ! touchable || ! touchable->GetVolume() ) return fUrgent;
+  auto volume = touchable->GetVolume()->GetLogicalVolume();
+  if ( ! fRunAction->GetStepFilter().IsRock(volume) ) return fUrgent;
+
+  auto particle = track->GetParticleDefinition();
+  if ( particle->GetPDGCharge() == 0. ) return fUrgent;
+  auto& counter = fRunAction->GetRangeKills();
+  counter.Count(particle->GetPDGEncoding());
+
+  G4bool nucleus = ( particle->GetParticleType() == "nucleus" );
+  if ( ! nucleus
+       && ( ! particle->GetPDGStable() || particle->GetBaryonNumber() < 0 ) ) {
+    return fUrgent;
+  }
+
+  // shortest path out of the rock, 0 if the point is not inside it
+  auto local = touchable->GetHistory()->GetTopTransform().TransformPoint(track->GetPosition());
+  G4double safety = volume->GetSolid()->DistanceToOut(local);
+  if ( safety <= fRangeMargin ) return fUrgent;
+
+  // 0 without energy loss tables
+  G4double energy = track->GetKineticEnergy();
+  G4double range = fEmCalculator.GetRangeFromRestricteDEDX(
+    energy, particle, volume->GetMaterial(), volume->GetRegion());
+  if ( range <= 0. || range + fRangeMargin >= safety ) return fUrgent;
+
+  counter.CountRejected(particle->GetPDGEncoding(), energy);
+  return fKill;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
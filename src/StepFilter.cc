@@ -0,0 +1,136 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepFilter.cc
+/// \brief Implementation of the StepFilter class
+
+#include "StepFilter.hh"
+#include "ScoringPlanes.hh"
+
+#include "G4LogicalVolumeStore.hh"
+#include "G4ParticleTable.hh"
+#include "G4ParticleTypes.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepFilter::StepFilter()
+ : fRockLV(nullptr),
+   fGapLV(nullptr),
+   fAbsoLV(nullptr),
+   fHistoIds(),
+   fPlanes()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepFilter::~StepFilter()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StepFilter::Resolve(const ScoringPlanes* planes,
+                          const std::vector<G4int>& firstHistoIds)
+{
+  auto store = G4LogicalVolumeStore::GetInstance();
+  fRockLV = store->GetVolume("Rock", false);
+  fGapLV  = store->GetVolume("Gap", false);
+  fAbsoLV = store->GetVolume("AbsoLV", false);
+
+  // a plane with a missing volume never matches
+  G4int nofMissing = 0;
+  fPlanes.clear();
+  if ( ! planes ) {
+    fPlanes.push_back({ fGapLV, fAbsoLV, -1, 1 });
+  }
+  else {
+    for (std::size_t i = 0; i < planes->GetNofPlanes(); ++i) {
+      const auto& plane = planes->GetPlane(i);
+      Plane resolved = { store->GetVolume(plane.preVolume, false),
+                         store->GetVolume(plane.postVolume, false),
+                         plane.copyNo,
+                         ( i < firstHistoIds.size() ) ? firstHistoIds[i] : -1 };
+      if ( ! resolved.preVolume || ! resolved.postVolume ) ++nofMissing;
+      if ( ! resolved.preVolume || ! resolved.postVolume || resolved.firstHistoId < 0 ) {
+        resolved.preVolume = resolved.postVolume = nullptr;
+      }
+      fPlanes.push_back(resolved);
+    }
+  }
+
+  // all particles defined so far, the ions met later are added on the fly
+  auto particleTable = G4ParticleTable::GetParticleTable();
+  fHistoIds.assign(particleTable->entries(), -1);
+  auto iterator = particleTable->GetIterator();
+  iterator->reset();
+  while ( (*iterator)() ) {
+    auto particle = iterator->value();
+    G4int id = particle->GetParticleDefinitionID();
+    if ( id < 0 ) continue;
+    if ( std::size_t(id) >= fHistoIds.size() ) fHistoIds.resize(id+1, -1);
+    fHistoIds[id] = Classify(particle);
+  }
+  return nofMissing;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4int StepFilter::Classify(const G4ParticleDefinition* particle)
+{
+  G4int ih = 0; 
+  const G4String& type = particle->GetParticleType();
+  if      (particle == G4Gamma::Gamma())                     ih = 2;
+  else if (particle == G4Electron::Electron())               ih = 3;
+  else if (particle == G4Positron::Positron())               ih = 3;  
+  else if (particle == G4MuonPlus::MuonPlus())               ih = 4;
+  else if (particle == G4MuonMinus::MuonMinus())             ih = 4;
+  else if (particle == G4Neutron::Neutron())                 ih = 5;
+  else if (particle == G4AntiNeutron::AntiNeutron())         ih = 6;
+  else if (particle == G4Proton::Proton())                   ih = 7;
+  else if (particle == G4AntiProton::AntiProton())           ih = 8;
+  else if (particle == G4PionPlus::PionPlus())               ih = 9;       
+  else if (particle == G4PionMinus::PionMinus())             ih = 10;       
+  else if (particle == G4PionZero::PionZero())               ih = 11;       
+  else if (particle == G4KaonZeroLong::KaonZeroLong())       ih = 12;       
+  else if (particle == G4KaonZeroShort::KaonZeroShort())     ih = 13;       
+  else if (particle == G4KaonZero::KaonZero())               ih = 14;       
+  else if (particle == G4AntiKaonZero::AntiKaonZero())       ih = 15;       
+  else if (particle == G4KaonPlus::KaonPlus())               ih = 16;       
+  else if (particle == G4KaonMinus::KaonMinus())             ih = 17;       
+  else if (particle == G4Lambda::Lambda())                   ih = 18;       
+  else if (particle == G4AntiLambda::AntiLambda())           ih = 19;
+  else if (particle == G4SigmaPlus::SigmaPlus())             ih = 20;
+  else if (particle == G4AntiSigmaPlus::AntiSigmaPlus())     ih = 21;
+  else if (particle == G4SigmaMinus::SigmaMinus())           ih = 22;
+  else if (particle == G4AntiSigmaMinus::AntiSigmaMinus())   ih = 23;
+  else if (particle == G4SigmaZero::SigmaZero())             ih = 24;
+  else if (particle == G4AntiSigmaZero::AntiSigmaZero())     ih = 25;
+  else if (type == "baryon")                                 ih = 26;         
+  else if (type == "meson")                                  ih = 27;
+  else if (type == "lepton")                                 ih = 28;
+  return ih;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,204 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file StepProfiler.cc
+/// \brief Implementation of the StepProfiler class
+
+#include "StepProfiler.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VProcess.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <vector>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t StepProfiler::KeyHash::operator()(const Key& key) const
+{
+  std::hash<const void*> hash;
+  std::size_t seed = hash(key.volume);
+  seed ^= hash(key.particle) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  seed ^= hash(key.process) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  return seed;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::StepProfiler()
+ : G4VAccumulable("StepProfiler"),
+   fCounts(),
+   fMerged(),
+   fLastKey{ nullptr, nullptr, nullptr },
+   fLastCounts(nullptr),
+   fLastTime()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::~StepProfiler()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+StepProfiler::Counts& StepProfiler::GetCounts(const Key& key)
+{
+  // consecutive steps mostly share the key; the map nodes do not move
+  if ( ! fLastCounts || ! ( key == fLastKey ) ) {
+    fLastCounts = &fCounts[key];
+    fLastKey = key;
+  }
+  return *fLastCounts;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::BeginTrack(const G4Track* track)
+{
+  auto volume = track->GetVolume() ? track->GetVolume()->GetLogicalVolume() : nullptr;
+  Key key = { volume, track->GetParticleDefinition(), track->GetCreatorProcess() };
+  GetCounts(key).nofTracks += 1;
+  fLastTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::EndStep(const G4Step* step)
+{
+  auto now = Clock::now();
+  const G4StepPoint* prePoint = step->GetPreStepPoint();
+  Key key = { prePoint->GetPhysicalVolume()->GetLogicalVolume(),
+              step->GetTrack()->GetParticleDefinition(),
+              step->GetPostStepPoint()->GetProcessDefinedStep() };
+  Counts& counts = GetCounts(key);
+  counts.nofSteps += 1;
+  counts.time += std::chrono::duration<G4double>(now - fLastTime).count();
+  fLastTime = now;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::AddByNames(std::map<Names, Counts>& to) const
+{
+  for (const auto& entry : fCounts) {
+    const Key& key = entry.first;
+    auto volume = static_cast<const G4LogicalVolume*>(key.volume);
+    auto particle = static_cast<const G4ParticleDefinition*>(key.particle);
+    auto process = static_cast<const G4VProcess*>(key.process);
+    Names names(volume ? volume->GetName() : G4String("none"),
+                particle->GetParticleName(),
+                process ? process->GetProcessName() : G4String("none"));
+    auto& counts = to[names];
+    counts.nofSteps += entry.second.nofSteps;
+    counts.nofTracks += entry.second.nofTracks;
+    counts.time += entry.second.time;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Merge(const G4VAccumulable& other)
+{
+  // called in the worker thread, whose volumes and processes are alive
+  static_cast<const StepProfiler&>(other).AddByNames(fMerged);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Reset()
+{
+  fCounts.clear();
+  fMerged.clear();
+  fLastCounts = nullptr;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<StepProfiler::Row> StepProfiler::GetRows() const
+{
+  std::map<Names, Counts> all(fMerged);
+  AddByNames(all);
+  std::vector<Row> rows;
+  for (const auto& entry : all) rows.push_back({ entry.first, entry.second });
+  std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+    return a.counts.time > b.counts.time;
+  });
+  return rows;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void StepProfiler::Print(G4int nofRows) const
+{
+  auto rows = GetRows();
+  G4double totalTime = 0.;
+  for (const auto& row : rows) totalTime += row.counts.time;
+
+  G4cout << "---> Step profile, " << std::min<std::size_t>(nofRows, rows.size())
+         << " of " << rows.size() << " rows (time in s):" << G4endl;
+  G4cout << "  " << std::left << std::setw(14) << "volume" << std::setw(14) << "particle"
+         << std::setw(18) << "process" << std::right << std::setw(14) << "steps"
+         << std::setw(12) << "tracks" << std::setw(12) << "time" << std::setw(8) << "%"
+         << G4endl;
+  for (G4int i = 0; i < nofRows && i < G4int(rows.size()); ++i) {
+    const auto& row = rows[i];
+    G4cout << "  " << std::left
+           << std::setw(14) << std::get<0>(row.names)
+           << std::setw(14) << std::get<1>(row.names)
+           << std::setw(18) << std::get<2>(row.names) << std::right
+           << std::setw(14) << row.counts.nofSteps
+           << std::setw(12) << row.counts.nofTracks
+           << std::setw(12) << std::setprecision(4) << row.counts.time
+           << std::setw(8) << std::setprecision(3)
+           << ( totalTime > 0. ? 100.*row.counts.time/totalTime : 0. ) << G4endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool StepProfiler::Write(const G4String& fileName) const
+{
+  std::ofstream output(fileName);
+  if ( ! output.is_open() ) return false;
+  output << "# volume particle process steps tracks time[s]" << std::endl;
+  output << std::setprecision(6);
+  for (const auto& row : GetRows()) {
+    output << std::get<0>(row.names) << ' ' << std::get<1>(row.names) << ' '
+           << std::get<2>(row.names) << ' ' << row.counts.nofSteps << ' '
+           << row.counts.nofTracks << ' ' << row.counts.time << std::endl;
+  }
+  return output.good();
+}
+
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
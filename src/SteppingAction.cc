@@ -31,17 +31,37 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "SteppingAction.hh"
+#include "RunAction.hh"
+#include "EventAction.hh"
+#include "PhaseSpaceFile.hh"
+#include "RockTables.hh"
+#include "StepFilter.hh"
+#include "HistogramBuffer.hh"
 #include "G4Step.hh"
-#include "G4ParticleTypes.hh"
+#include "G4LogicalVolume.hh"
+#include "G4RunManager.hh"
+#include "G4Run.hh"
+#include "G4Event.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4UnitsTable.hh"
 #include "g4root.hh"
 #include "Analysis.hh"
 
+#include <cstdlib>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-SteppingAction::SteppingAction()
-:G4UserSteppingAction()
+SteppingAction::SteppingAction(RunAction* runAction, EventAction* eventAction)
+:G4UserSteppingAction(),
+ fRunAction(runAction),
+ fEventAction(eventAction),
+ fStepFilter(&runAction->GetStepFilter()),
+ fHistograms(&runAction->GetHistograms()),
+ fRockEntryEnergy(0.),
+ fRockEntryPosition(),
+ fRockEntryDirection(),
+ fRockMuonDone(false)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -53,84 +73,142 @@ SteppingAction::~SteppingAction()
 
 void SteppingAction::UserSteppingAction(const G4Step* aStep)
 {
-  const G4Track* track = aStep->GetTrack();
-  //if(track->GetParentID()!=0) return;
+  fRunAction->CountStep();
+  auto profiler = fRunAction->GetStepProfiler();
+  if ( profiler ) profiler->EndStep(aStep);
+  if ( fRunAction->IsRockCalibration() ) CalibrateRock(aStep);
 
   G4StepStatus status = aStep->GetPostStepPoint()->GetStepStatus();
   if(status != fGeomBoundary) return;
   
-  G4String name1 = aStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName();
-  G4String name2;
-  if(status != fWorldBoundary) name2 = aStep->GetPostStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName();
+  // volumes resolved at the start of run, compared by pointer
+  const G4LogicalVolume* volume1 = aStep->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
+  const G4LogicalVolume* volume2 = aStep->GetPostStepPoint()->GetPhysicalVolume()->GetLogicalVolume();
 
-  if(!( name1=="Gap" && name2=="AbsoLV" )) return;
-  //printf("Xin1: %s %s\n",name1.data(),name2.data());
-  
+  // crossing of the scoring planes, the first one is the entry into the absorber
+  for (std::size_t plane = 0; plane < fStepFilter->GetNofPlanes(); ++plane) {
+    if ( fStepFilter->IsOnPlane(plane, volume1, volume2, aStep->GetPostStepPoint()) ) {
+      ScoreCrossing(aStep, plane);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SteppingAction::ScoreCrossing(const G4Step* aStep, std::size_t plane)
+{
+  const G4Track* track = aStep->GetTrack();
   const G4ParticleDefinition* particle = track->GetParticleDefinition();
-  G4String name    = particle->GetParticleName();
   G4int particleID = particle->GetPDGEncoding();
-  G4String type    = particle->GetParticleType();      
-  G4double chargeP = particle->GetPDGCharge();
   G4double energy  = aStep->GetPreStepPoint()->GetKineticEnergy();
   //printf("Xin2: %d %g\n",track->GetParentID(),energy/GeV);
 
-  // histograms: enery flow
+  // a particle replayed from a phase space keeps its stage-1 parent
+  G4int parentID = track->GetParentID();
+  if ( parentID == 0 ) {
+    auto primary = track->GetDynamicParticle()->GetPrimaryParticle();
+    auto info = primary
+      ? dynamic_cast<const PhaseSpaceInfo*>(primary->GetUserInformation()) : nullptr;
+    if ( info ) parentID = info->GetParent();
+  }
+
+  // stage 1 of a two-stage simulation: the entry into the absorber
+  auto phaseSpaceOutput = fEventAction->GetPhaseSpaceOutput();
+  if ( phaseSpaceOutput && plane == 0 ) {
+    const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+    const G4ThreeVector& position = postPoint->GetPosition();
+    const G4ThreeVector& direction = postPoint->GetMomentumDirection();
+    auto event = G4RunManager::GetRunManager()->GetCurrentEvent();
+    auto run = G4RunManager::GetRunManager()->GetCurrentRun();
+    PhaseSpaceRecord record;
+    record.run = run ? run->GetRunID() : 0;
+    record.event = event ? event->GetEventID() : 0;
+    record.pdg = particleID;
+    record.parent = parentID;
+    record.energy = postPoint->GetKineticEnergy()/GeV;
+    record.x = position.x()/cm;
+    record.y = position.y()/cm;
+    record.z = position.z()/cm;
+    record.dx = direction.x();
+    record.dy = direction.y();
+    record.dz = direction.z();
+    record.time = postPoint->GetGlobalTime()/ns;
+    record.weight = w_beam;
+    fEventAction->AddCrossing(record);
+    if ( phaseSpaceOutput->GetKillAtBoundary() ) aStep->GetTrack()->SetTrackStatus(fStopAndKill);
+  }
+
+  // histograms: enery flow, buffered until the end of run
   //
-  G4AnalysisManager* analysis = G4AnalysisManager::Instance();
- 
   G4int ih = 0; 
-  if(track->GetParentID()==0)                        {
+  if(parentID==0 && plane!=0) ih = 1;
+  else if(parentID==0)                               {
     ih = 1;
     pdg_primary = particleID;
     e_primary = energy;
     x_primary = aStep->GetPreStepPoint()->GetPosition().x();
     y_primary = aStep->GetPreStepPoint()->GetPosition().y();
   }
-  else if (particle == G4Gamma::Gamma())             ih = 2;
-  else if (particle == G4Electron::Electron())       ih = 3;
-  else if (particle == G4Positron::Positron())       ih = 3;  
-  else if (particle == G4MuonPlus::MuonPlus())       ih = 4;
-  else if (particle == G4MuonMinus::MuonMinus())     ih = 4;
-  else if (particle == G4Neutron::Neutron())         {
-    ih = 5;
-    // pdg_neutron = particleID;
-    // e_neutron = energy;
-    // x_neutron = aStep->GetPreStepPoint()->GetPosition().x();
-    // y_neutron = aStep->GetPreStepPoint()->GetPosition().y();
-  }
-  else if (particle == G4AntiNeutron::AntiNeutron()) {
-    ih = 6;
-    // pdg_neutron = particleID;
-    // e_neutron = energy;
-    // x_neutron = aStep->GetPreStepPoint()->GetPosition().x();
-    // y_neutron = aStep->GetPreStepPoint()->GetPosition().y();
-  }
-  else if (particle == G4Proton::Proton())                   ih = 7;
-  else if (particle == G4AntiProton::AntiProton())           ih = 8;
-  else if (particle == G4PionPlus::PionPlus())               ih = 9;       
-  else if (particle == G4PionMinus::PionMinus())             ih = 10;       
-  else if (particle == G4PionZero::PionZero())               ih = 11;       
-  else if (particle == G4KaonZeroLong::KaonZeroLong())       ih = 12;       
-  else if (particle == G4KaonZeroShort::KaonZeroShort())     ih = 13;       
-  else if (particle == G4KaonZero::KaonZero())               ih = 14;       
-  else if (particle == G4AntiKaonZero::AntiKaonZero())       ih = 15;       
-  else if (particle == G4KaonPlus::KaonPlus())               ih = 16;       
-  else if (particle == G4KaonMinus::KaonMinus())             ih = 17;       
-  else if (particle == G4Lambda::Lambda())                   ih = 18;       
-  else if (particle == G4AntiLambda::AntiLambda())           ih = 19;
-  else if (particle == G4SigmaPlus::SigmaPlus())             ih = 20;
-  else if (particle == G4AntiSigmaPlus::AntiSigmaPlus())     ih = 21;
-  else if (particle == G4SigmaMinus::SigmaMinus())           ih = 22;
-  else if (particle == G4AntiSigmaMinus::AntiSigmaMinus())   ih = 23;
-  else if (particle == G4SigmaZero::SigmaZero())             ih = 24;
-  else if (particle == G4AntiSigmaZero::AntiSigmaZero())     ih = 25;
-  else if (type == "baryon")                                 ih = 26;         
-  else if (type == "meson")                                  ih = 27;
-  else if (type == "lepton")                                 ih = 28;
+  else ih = fStepFilter->GetHistoId(particle);
 
   //printf("Xin3: ih = %d\n",ih);
-  if (ih > 0) analysis->FillH1(ih,energy/GeV);
+  // weighted by the primary, 1 unless the energy is importance sampled
+  if (ih > 0) fHistograms->Fill(fStepFilter->GetFirstHistoId(plane)+ih-1,energy/GeV,w_beam);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void SteppingAction::CalibrateRock(const G4Step* aStep)
+{
+  // the primary muon is tracked before its secondaries, its entry
+  // energy is known when these leave the rock
+  const G4Track* track = aStep->GetTrack();
+  G4bool primary = ( track->GetParentID() == 0 );
+  if ( primary && track->GetCurrentStepNumber() == 1 ) {
+    fRockEntryEnergy = 0.;
+    fRockMuonDone = false;
+  }
+
+  const G4StepPoint* prePoint = aStep->GetPreStepPoint();
+  const G4StepPoint* postPoint = aStep->GetPostStepPoint();
+  const G4LogicalVolume* postVolume = postPoint->GetPhysicalVolume()
+    ? postPoint->GetPhysicalVolume()->GetLogicalVolume() : nullptr;
+  G4bool preRock = fStepFilter->IsRock(prePoint->GetPhysicalVolume()->GetLogicalVolume());
+  G4bool postRock = fStepFilter->IsRock(postVolume);
+  G4bool muon = ( std::abs(track->GetParticleDefinition()->GetPDGEncoding()) == 13 );
+
+  if ( primary && muon && ! preRock && postRock ) {
+    fRockEntryEnergy = postPoint->GetKineticEnergy();
+    fRockEntryPosition = postPoint->GetPosition();
+    fRockEntryDirection = postPoint->GetMomentumDirection();
+    return;
+  }
+  if ( ! preRock || fRockEntryEnergy == 0. ) return;
+
+  RockTables& tables = fRunAction->GetRockTables();
+  if ( primary ) {
+    if ( fRockMuonDone ) return;
+    if ( ! postRock ) {
+      tables.FillMuon(fRockEntryEnergy,
+                      (postPoint->GetPosition()-fRockEntryPosition).mag(),
+                      postPoint->GetKineticEnergy(),
+                      postPoint->GetMomentumDirection().angle(fRockEntryDirection));
+      fRockMuonDone = true;
+    }
+    else if ( track->GetTrackStatus() != fAlive ) {
+      tables.FillMuon(fRockEntryEnergy, 0., 0., 0.);
+      fRockMuonDone = true;
+    }
+  }
+  else if ( ! postRock
+            && postPoint->GetMomentumDirection().dot(fRockEntryDirection) > 0. ) {
+    // on leaving the rock, mostly into the Station as the slanted exit face
+    // only touches the Gap along an edge; forward only, the model emits
+    // them at the exit face
+    tables.FillSecondary(fRockEntryEnergy,
+                         track->GetParticleDefinition()->GetPDGEncoding(),
+                         postPoint->GetKineticEnergy());
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
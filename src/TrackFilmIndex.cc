@@ -0,0 +1,84 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file TrackFilmIndex.cc
+/// \brief Implementation of the TrackFilmIndex class
+
+#include "TrackFilmIndex.hh"
+
+#include <limits>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackFilmIndex::TrackFilmIndex(std::size_t nofSlots)
+ : fSlots(),
+   fMask(0),
+   fSize(0),
+   fGeneration(1)
+{
+  // a power of two, for the mask
+  std::size_t size = 16;
+  while ( size < nofSlots ) size *= 2;
+  fSlots.assign(size, Slot{ 0, 0, 0 });
+  fMask = size - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackFilmIndex::~TrackFilmIndex()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackFilmIndex::Clear()
+{
+  fSize = 0;
+  if ( fGeneration < std::numeric_limits<G4int>::max() ) {
+    ++fGeneration;
+    return;
+  }
+
+  // after 2^31 events, the stale generations are reset
+  for (auto& slot : fSlots) slot.generation = 0;
+  fGeneration = 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackFilmIndex::Grow()
+{
+  std::vector<Slot> slots(2*fSlots.size(), Slot{ 0, 0, 0 });
+  slots.swap(fSlots);
+  fMask = fSlots.size() - 1;
+  for (const auto& slot : slots) {
+    if ( slot.generation != fGeneration ) continue;
+    std::size_t i = Hash(slot.key) & fMask;
+    while ( fSlots[i].generation == fGeneration ) i = (i+1) & fMask;
+    fSlots[i] = slot;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
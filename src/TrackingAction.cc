@@ -31,76 +31,23 @@
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 #include "TrackingAction.hh"
+#include "RunAction.hh"
 
-#include "G4RunManager.hh"
 #include "G4Track.hh"
-#include "G4StepStatus.hh"
-#include "G4ParticleTypes.hh"
-
-#include "G4SystemOfUnits.hh"
-#include "G4UnitsTable.hh"
-#include "g4root.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-TrackingAction::TrackingAction()
-:G4UserTrackingAction()
+TrackingAction::TrackingAction(RunAction* runAction)
+:G4UserTrackingAction(),
+ fRunAction(runAction)
 { }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void TrackingAction::PostUserTrackingAction(const G4Track* track)
+void TrackingAction::PreUserTrackingAction(const G4Track* track)
 {
-  if(track->GetParentID()!=0) return;
-  
-  // keep only boundary particles
-  G4StepStatus status = track->GetStep()->GetPostStepPoint()->GetStepStatus();
-  //printf("%d ",(int)status);
-  //if (status != fGeomBoundary) return;
-  //printf("Xin2\n");
-
-  G4String name1 = track->GetStep()->GetPreStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName();
-  G4String name2;
-  if(status != fWorldBoundary)
-    name2 = track->GetStep()->GetPostStepPoint()->GetPhysicalVolume()->GetLogicalVolume()->GetName();
-  if(true) printf("%s %s\n",name1.data(),name2.data());
-  //G4cout << "Xin: " << name1 << " " << name2 << G4endl;
-  //printf("%s ",name1.data());
-  return;
-  
-  // //if(name1 == "Rock" || name1 != "Station") return;
-  // //if(! ((name1 == "Rock" || name1 == "Station") && (name2 == "Calorimeter" || name2 == "Layer" || name2 == "AbsoLV"))) return;
- 
-  // const G4ParticleDefinition* particle = track->GetParticleDefinition();
-  // G4String name    = particle->GetParticleName();
-  // //G4int particleID = particle->GetPDGEncoding();
-  // G4double energy  = track->GetKineticEnergy();
-
-  // // histograms: enery flow
-  // //
-  // G4AnalysisManager* analysis = G4AnalysisManager::Instance();
- 
-  // G4int ih = 0; 
-  // G4String type   = particle->GetParticleType();      
-  // G4double charge = particle->GetPDGCharge();
-  // if(track->GetParentID()==0) ih = 1;
-  // else if (charge > 3.) ih = 8; 
-  // else if (particle == G4Gamma::Gamma())             ih = 2;
-  // else if (particle == G4Electron::Electron())       ih = 3;
-  // else if (particle == G4Positron::Positron())       ih = 3;  
-  // else if (particle == G4MuonPlus::MuonPlus())       ih = 4;
-  // else if (particle == G4MuonMinus::MuonMinus())     ih = 4;
-  // else if (particle == G4Neutron::Neutron())         ih = 5;
-  // else if (particle == G4AntiNeutron::AntiNeutron()) ih = 5;
-  // else if (particle == G4Proton::Proton())           ih = 6;
-  // else if (particle == G4AntiProton::AntiProton())   ih = 6;
-  // else if (particle == G4Alpha::Alpha())             ih = 7;       
-  // else if (particle == G4AntiAlpha::AntiAlpha())     ih = 7;       
-  // else if (type == "nucleus")                        ih = 8;
-  // else if (type == "baryon")                         ih = 9;         
-  // else if (type == "meson")                          ih = 10;
-  // else if (type == "lepton")                         ih = 11;        
-  // if (ih > 0) analysis->FillH1(ih,energy/GeV);
+  auto profiler = fRunAction->GetStepProfiler();
+  if ( profiler ) profiler->BeginTrack(track);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......